@@ -0,0 +1,135 @@
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+
+const float AllocationTracker::k_warmupDuration = 10.0f;
+
+std::atomic<bool> AllocationTracker::s_isEnabled(false);
+AllocationTracker::Counter AllocationTracker::s_phases[Profiler::PHASE_COUNT + 1];
+AllocationTracker::Counter AllocationTracker::s_subsystems[SUBSYSTEM_COUNT];
+AllocationTracker::Counter AllocationTracker::s_violations;
+std::atomic<unsigned char> AllocationTracker::s_firstViolationPhase(Profiler::PHASE_COUNT);
+
+thread_local bool AllocationTracker::t_isStrict = false;
+thread_local AllocationTracker::Subsystem AllocationTracker::t_subsystem = AllocationTracker::SUBSYSTEM_COUNT;
+
+
+void AllocationTracker::Record(size_t size)
+{
+	if (!IsEnabled()) { return; }
+
+	const Profiler::Phase phase = Profiler::GetCurrentPhase();
+
+	s_phases[phase].count.fetch_add(1, std::memory_order_relaxed);
+	s_phases[phase].bytes.fetch_add(size, std::memory_order_relaxed);
+
+	if (t_subsystem != SUBSYSTEM_COUNT)
+	{
+		s_subsystems[t_subsystem].count.fetch_add(1, std::memory_order_relaxed);
+		s_subsystems[t_subsystem].bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	if (t_isStrict)
+	{
+		if (s_violations.count.fetch_add(1, std::memory_order_relaxed) == 0) { s_firstViolationPhase.store(phase, std::memory_order_relaxed); }
+		s_violations.bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+}
+
+
+void AllocationTracker::TrackTexture(SDL_Texture* texture)
+{
+	if (!IsEnabled() || texture == nullptr) { return; }
+
+	s_subsystems[TEXTURES].count.fetch_add(1, std::memory_order_relaxed);
+	s_subsystems[TEXTURES].bytes.fetch_add(GetTextureSize(texture), std::memory_order_relaxed);
+}
+
+
+void AllocationTracker::UntrackTexture(SDL_Texture* texture)
+{
+	if (!IsEnabled() || texture == nullptr) { return; }
+
+	s_subsystems[TEXTURES].count.fetch_sub(1, std::memory_order_relaxed);
+	s_subsystems[TEXTURES].bytes.fetch_sub(GetTextureSize(texture), std::memory_order_relaxed);
+}
+
+
+AllocationTracker::Totals AllocationTracker::GetPhaseTotals(Profiler::Phase phase)
+{
+	return Load(s_phases[phase]);
+}
+
+
+AllocationTracker::Totals AllocationTracker::GetSubsystemTotals(Subsystem subsystem)
+{
+	return Load(s_subsystems[subsystem]);
+}
+
+
+AllocationTracker::Totals AllocationTracker::GetViolations()
+{
+	return Load(s_violations);
+}
+
+
+const char* AllocationTracker::GetSubsystemName(Subsystem subsystem)
+{
+	switch (subsystem)
+	{
+		case ENTITIES: return "Entities";
+		case ANIMATIONS: return "Animations";
+		case LISTENERS: return "Listeners";
+		case TEXTURES: return "Textures";
+		default: return "Unknown";
+	}
+}
+
+
+AllocationTracker::Totals AllocationTracker::Load(const Counter& counter)
+{
+	return { counter.count.load(std::memory_order_relaxed), counter.bytes.load(std::memory_order_relaxed) };
+}
+
+
+size_t AllocationTracker::GetTextureSize(SDL_Texture* texture)
+{
+	Uint32 format;
+	int width, height;
+
+	if (SDL_QueryTexture(texture, &format, nullptr, &width, &height) != 0) { return 0; }
+
+	return static_cast<size_t>(width) * static_cast<size_t>(height) * SDL_BYTESPERPIXEL(format);
+}
+
+
+//replaced for the whole program; array and nothrow forms end up here too
+void* operator new(size_t size)
+{
+	AllocationTracker::Record(size);
+
+	for (;;)
+	{
+		void* memory = malloc(size > 0 ? size : 1);
+		if (memory != nullptr) { return memory; }
+
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr) { throw std::bad_alloc(); }
+
+		handler();
+	}
+}
+
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
\ No newline at end of file
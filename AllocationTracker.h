@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+
+#include <SDL.h>
+
+#include "Profiler.h"
+
+
+// opt-in counting of global operator new: allocations and bytes per frame phase and
+// per subsystem, plus live texture memory. Threads may turn strict after warm-up,
+// every allocation they make from then on is recorded as a violation
+
+
+class AllocationTracker //static
+{
+public:
+	enum Subsystem : unsigned char
+	{
+		ENTITIES,
+		ANIMATIONS,
+		LISTENERS,
+		TEXTURES,
+		SUBSYSTEM_COUNT
+	};
+
+	struct Totals
+	{
+		Uint64 count;
+		Uint64 bytes;
+	};
+
+	static const float k_warmupDuration; //seconds of simulated time before a match is expected to stop allocating
+
+	inline static bool IsEnabled() { return s_isEnabled.load(std::memory_order_relaxed); }
+	inline static void SetEnabled(bool enabled) { s_isEnabled.store(enabled, std::memory_order_relaxed); }
+
+	inline static bool IsStrict() { return t_isStrict; }
+	inline static void SetStrict(bool strict) { t_isStrict = strict; } //calling thread only
+
+	static void Record(size_t size); //from operator new, must not allocate itself
+
+	static void TrackTexture(SDL_Texture* texture); //live texture bytes, by the size SDL reports
+	static void UntrackTexture(SDL_Texture* texture); //before destroying it
+
+	static Totals GetPhaseTotals(Profiler::Phase phase); //PHASE_COUNT for allocations outside of all phases
+	static Totals GetSubsystemTotals(Subsystem subsystem); //textures: live ones; others: allocated within their scopes
+	static Totals GetViolations();
+	inline static Profiler::Phase GetFirstViolationPhase() { return static_cast<Profiler::Phase>(s_firstViolationPhase.load(std::memory_order_relaxed)); }
+
+	static const char* GetSubsystemName(Subsystem subsystem);
+
+private:
+	friend class AllocationScope;
+
+	struct Counter
+	{
+		std::atomic<Uint64> count;
+		std::atomic<Uint64> bytes;
+	};
+
+	static std::atomic<bool> s_isEnabled;
+	static Counter s_phases[Profiler::PHASE_COUNT + 1];
+	static Counter s_subsystems[SUBSYSTEM_COUNT];
+	static Counter s_violations;
+	static std::atomic<unsigned char> s_firstViolationPhase;
+
+	static thread_local bool t_isStrict;
+	static thread_local Subsystem t_subsystem; //SUBSYSTEM_COUNT outside of all scopes
+
+	static Totals Load(const Counter& counter);
+	static size_t GetTextureSize(SDL_Texture* texture);
+};
+
+
+//allocations made by the calling thread within the scope are added to the subsystem
+class AllocationScope final
+{
+public:
+	inline explicit AllocationScope(AllocationTracker::Subsystem subsystem) :
+		m_previousSubsystem(AllocationTracker::t_subsystem)
+	{
+		AllocationTracker::t_subsystem = subsystem;
+	}
+
+	inline ~AllocationScope()
+	{
+		AllocationTracker::t_subsystem = m_previousSubsystem;
+	}
+
+	AllocationScope(const AllocationScope& other) = delete;
+	AllocationScope& operator= (const AllocationScope& other) = delete;
+
+private:
+	const AllocationTracker::Subsystem m_previousSubsystem;
+};
\ No newline at end of file
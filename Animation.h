@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include <SDL.h>
@@ -40,7 +41,7 @@ public:
 	};
 
 public:
-	Animation() = default;
+	inline Animation() : m_duration(0.0f), m_isLooped(false) {}
 	Animation(const Animation &other) = default;
 	virtual ~Animation() = default;
 
@@ -52,7 +53,7 @@ public:
 	inline void SetLoop(bool enableLoop) { m_isLooped = enableLoop; }
 	inline void SetNextState(const std::string& animation) { m_nextState = animation; }
 
-	inline void OnFinish(std::function<void()> callback) { m_onFinish.AddListener(callback); }
+	inline EventHandle OnFinish(Event<void()>::Listener callback) { return m_onFinish.AddListener(callback); }
 
 protected:
 	float m_duration;
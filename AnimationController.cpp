@@ -2,13 +2,12 @@
 
 #include <glm/glm.hpp>
 
-#include "Game.h"
-
 
 AnimationController::AnimationController() :
 	m_moment(0.0f),
 	m_isPaused(false),
-	m_currentAnimation("")
+	m_currentAnimation(""),
+	m_animation(nullptr)
 {}
 
 
@@ -21,7 +20,7 @@ AnimationController::~AnimationController()
 }
 
 
-void AnimationController::Update()
+void AnimationController::Update(float deltaTime)
 {
 	if (m_isPaused) { return; }
 
@@ -30,17 +29,16 @@ void AnimationController::Update()
 		if (m_animations.empty()) { return; }
 
 		m_currentAnimation = m_animations.begin()->first;
+		m_animation = m_animations.begin()->second;
 	}
 
-	const auto it = m_animations.find(m_currentAnimation);
-
-	if (it == m_animations.end()) { return; }
+	if (!m_animation) { return; }
 
-	const Animation& animation = *it->second;
+	const Animation& animation = *m_animation;
 
 	if (animation.m_duration > 0.0f)
 	{
-		m_moment += Game::deltaTime;
+		m_moment += deltaTime;
 
 		if (m_moment >= animation.m_duration)
 		{
@@ -52,7 +50,9 @@ void AnimationController::Update()
 			}
 			else if (!animation.m_nextState.empty())
 			{
+				const auto next = m_animations.find(animation.m_nextState);
 				m_currentAnimation = animation.m_nextState;
+				m_animation = (next != m_animations.end()) ? next->second : nullptr;
 			}
 		}
 	}
@@ -66,10 +66,20 @@ void AnimationController::Play(const std::string& animation)
 	if (find == m_animations.end()) { return; }
 
 	m_currentAnimation = animation;
+	m_animation = find->second;
 	m_moment = 0.0f;
 }
 
 
+bool AnimationController::IsAnimating() const
+{
+	if (m_isPaused) { return false; }
+	if (!m_animation) { return m_currentAnimation.empty() && !m_animations.empty(); }
+
+	return m_animation->m_duration > 0.0f && (m_animation->m_isLooped || m_moment < m_animation->m_duration);
+}
+
+
 void AnimationController::PlayIfNotPlaying(const std::string& animation)
 {
 	if (m_currentAnimation != animation) { Play(animation); }
@@ -12,13 +12,14 @@ public:
 	AnimationController();
 	~AnimationController();
 
-	void Update();
+	void Update(float deltaTime);
+	bool IsAnimating() const; //false while updates change nothing: paused, still or finished
 
 	void Play(const std::string& animation);
 	void PlayIfNotPlaying(const std::string& animation);
 
 	inline const std::string& GetCurrentAnimation() { return m_currentAnimation; }
-	inline const Animation::Frame& GetCurrentFrame() { return m_animations[m_currentAnimation]->GetFrame(m_moment); }
+	inline const Animation::Frame& GetCurrentFrame() { return m_animation->GetFrame(m_moment); }
 	inline Animation* GetAnimation(const std::string& animation) { return m_animations[animation]; }
 	inline bool HaveAnimation(const std::string& animation) { return m_animations.find(animation) != m_animations.end(); }
 
@@ -35,4 +36,5 @@ private:
 
 	std::map<std::string, Animation*> m_animations;
 	std::string m_currentAnimation;
+	const Animation* m_animation; //current one, null until the first update picks it
 };
\ No newline at end of file
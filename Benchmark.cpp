@@ -0,0 +1,683 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include <SDL.h>
+
+#include "AllocationTracker.h"
+#include "Controller.h"
+#include "Entity.h"
+#include "Event.h"
+#include "GameWorld.h"
+
+
+namespace
+{
+	const unsigned int k_seed = 20190601;
+
+	const size_t k_inputCount = 4096; //power of two
+	const size_t k_operationsPerRound = 1 << 18;
+	const int k_rounds = 7; //best round is reported
+
+	const float k_reverseWindowRatio = 4.0f / 3.0f;
+	const float k_deltaTime = 1.0f / 240.0f;
+	const float k_maxSpeed = 2.0f;
+
+	const double k_regressionThreshold = 0.10; //slower than baseline by more than that ratio
+
+	const float k_nearestPointTolerance = 1e-5f; //vector and scalar kernels may round differently
+
+	const unsigned int k_threadsPuckCount = 500;
+	const unsigned int k_threadsTicks = 2000;
+	const unsigned int k_physicsThreadCounts[] = { 1, 2, 4, 8 };
+
+	const unsigned int k_revalidationPuckCount = 300;
+	const unsigned int k_revalidationTicks = 4000;
+	const double k_minRevalidatedRatio = 0.03; //crowds mostly slide along their contacts, only the ones barely moving keep them
+	const float k_revalidatedNormalTolerance = 0.9962f; //cosine of the angle a kept normal may be off a full test, about 5 degrees
+	const float k_revalidatedDistanceTolerance = 0.0002f; //a kept time may be off by that much travel, in playground widths
+
+	const unsigned int k_churnPuckCount = 300;
+	const unsigned int k_churnWarmupTicks = 240; //contacts are cached by then
+	const unsigned int k_churnRounds = 200;
+	const size_t k_churnBatch = 50; //arena pucks despawned and spawned again every round
+
+	volatile float s_sink; //keeps results alive so the optimizer can't drop measured code
+
+
+	//a revalidated contact has to be what a full test of its pair finds, within tolerances
+	struct RevalidationCheck
+	{
+		size_t checkedCount = 0, mismatchCount = 0;
+		float minNormalDot = 1.0f, maxDistanceError = 0.0f;
+
+		void Compare(const manifold& kept, const manifold& tested, const glm::vec2& displacement)
+		{
+			checkedCount++;
+
+			if (kept.isHit != tested.isHit)
+			{
+				mismatchCount++;
+				return;
+			}
+
+			if (!kept.isHit) { return; }
+
+			const float normalDot = glm::dot(kept.normal, tested.normal);
+			const float distanceError = glm::abs(kept.time - tested.time) * glm::length(displacement);
+
+			minNormalDot = glm::min(minNormalDot, normalDot);
+			maxDistanceError = glm::max(maxDistanceError, distanceError);
+
+			if (normalDot < k_revalidatedNormalTolerance || distanceError > k_revalidatedDistanceTolerance) { mismatchCount++; }
+		}
+	};
+
+
+	struct Random
+	{
+		std::mt19937 engine;
+
+		Random() : engine(k_seed) {}
+
+		float Range(float min, float max) { return std::uniform_real_distribution<float>(min, max)(engine); }
+		glm::vec2 Point() { return glm::vec2(Range(0.0f, 1.0f), Range(0.0f, k_reverseWindowRatio)); }
+		glm::vec2 Velocity() { return glm::vec2(Range(-k_maxSpeed, k_maxSpeed), Range(-k_maxSpeed, k_maxSpeed)); }
+		glm::vec2 Size() { return glm::vec2(Range(0.02f, 0.4f), Range(0.02f, 0.4f)); }
+	};
+
+
+	template<typename Operation>
+	Benchmark::Result Measure(const char* name, Operation operation)
+	{
+		double bestTicks = std::numeric_limits<double>::max();
+
+		for (int round = 0; round < k_rounds; round++)
+		{
+			float sum = 0.0f;
+
+			const Uint64 start = SDL_GetPerformanceCounter();
+
+			for (size_t i = 0; i < k_operationsPerRound; i++)
+			{
+				sum += operation(i & (k_inputCount - 1));
+			}
+
+			const Uint64 finish = SDL_GetPerformanceCounter();
+
+			s_sink = sum;
+			bestTicks = std::min(bestTicks, static_cast<double>(finish - start));
+		}
+
+		const double nanoseconds = bestTicks * 1e9 / SDL_GetPerformanceFrequency() / k_operationsPerRound;
+
+		return { name, nanoseconds, nanoseconds > 0.0 ? 1e9 / nanoseconds : 0.0 };
+	}
+}
+
+
+bool Benchmark::Run(const Settings& settings)
+{
+	if (!VerifyBorderSet()) { return false; }
+	if (!VerifyPhysicsThreads()) { return false; }
+	if (!VerifyRevalidation()) { return false; }
+	if (!VerifySpawnChurn()) { return false; }
+	if (!VerifyEvents()) { return false; }
+
+	const std::vector<Result> results = RunAll();
+	const std::string json = ToJson(results);
+
+	if (settings.benchmarkOutput.empty())
+	{
+		std::cout << json;
+	}
+	else
+	{
+		std::ofstream stream(settings.benchmarkOutput);
+
+		if (!stream)
+		{
+			std::cerr << "Failed to write benchmark report " << settings.benchmarkOutput << "\n";
+			return false;
+		}
+
+		stream << json;
+	}
+
+	if (settings.benchmarkBaseline.empty()) { return true; }
+
+	std::ifstream stream(settings.benchmarkBaseline);
+
+	if (!stream)
+	{
+		std::cerr << "Failed to read benchmark baseline " << settings.benchmarkBaseline << "\n";
+		return false;
+	}
+
+	std::stringstream baseline;
+	baseline << stream.rdbuf();
+
+	return Compare(results, FromJson(baseline.str()));
+}
+
+
+std::vector<Benchmark::Result> Benchmark::RunAll()
+{
+	std::vector<Result> results;
+
+	Random random;
+
+	std::vector<circle> circles(k_inputCount);
+	std::vector<line> lines(k_inputCount);
+	std::vector<rectangle> rectangles(k_inputCount);
+	std::vector<shape> shapes(k_inputCount);
+	std::vector<glm::vec2> points(k_inputCount);
+	std::vector<glm::vec2> velocities(k_inputCount);
+	std::vector<manifold> contacts(k_inputCount);
+	std::vector<hull> outlines(k_inputCount);
+	std::vector<convex> hulls(k_inputCount);
+	std::vector<Gjk::Simplex> simplices(k_inputCount);
+
+	for (size_t i = 0; i < k_inputCount; i++)
+	{
+		circles[i] = circle(random.Point(), random.Range(0.01f, 0.1f));
+		lines[i] = line(random.Point(), random.Point());
+		rectangles[i] = rectangle(random.Point(), random.Size());
+		points[i] = random.Point();
+		velocities[i] = random.Velocity();
+
+		shapes[i].m_type = (random.engine() & 1) ? shape::CIRCLE : shape::RECTANGLE;
+
+		if (shapes[i].m_type == shape::CIRCLE)
+		{
+			shapes[i].m_data.m_circle = circles[i];
+		}
+		else
+		{
+			shapes[i].m_data.m_rectangle = rectangles[i];
+		}
+	}
+
+	for (size_t i = 0; i < k_inputCount; i++) //drawn last, earlier inputs stay comparable with old baselines
+	{
+		contacts[i] = manifold(0.0f, glm::normalize(random.Velocity()), 0.01f, points[i]);
+	}
+
+	for (size_t i = 0; i < k_inputCount; i++) //capsules and rounded boxes, like custom paddles
+	{
+		if (i & 1)
+		{
+			const glm::vec2 point1 = random.Point();
+			const glm::vec2 point2 = random.Point() * 0.2f + points[i] * 0.8f;
+
+			outlines[i] = hull::Capsule((point2 - point1) * 0.5f, random.Range(0.01f, 0.05f));
+			hulls[i] = convex((point1 + point2) * 0.5f, outlines[i]);
+		}
+		else
+		{
+			const glm::vec2 position = random.Point();
+
+			outlines[i] = hull::Box(random.Size() * 0.5f, random.Range(0.0f, 0.02f));
+			hulls[i] = convex(position, outlines[i]);
+		}
+	}
+
+	const auto next = [](size_t i) { return (i + 1) & (k_inputCount - 1); };
+
+	results.push_back(Measure("circle::Contact(circle)", [&](size_t i) { return circles[i].Contact(circles[next(i)]).depth; }));
+	results.push_back(Measure("line::Contact(circle)", [&](size_t i) { return lines[i].Contact(circles[i]).depth; }));
+	results.push_back(Measure("line::Nearest", [&](size_t i) { return lines[i].Nearest(points[i]).x; }));
+	results.push_back(Measure("rectangle::Contain", [&](size_t i) { return rectangles[i].Contain(points[i]) ? 1.0f : 0.0f; }));
+	results.push_back(Measure("rectangle::Nearest", [&](size_t i) { return rectangles[i].Nearest(points[i]).x; }));
+	results.push_back(Measure("rectangle::Contact(rectangle)", [&](size_t i) { return rectangles[i].Contact(rectangles[next(i)]).depth; }));
+	results.push_back(Measure("shape::Contact", [&](size_t i) { return shapes[i].Contact(shapes[next(i)]).depth; }));
+	results.push_back(Measure("circle::Sweep(circle)", [&](size_t i) { return circles[i].Sweep(velocities[i], circles[next(i)]).time; }));
+	results.push_back(Measure("circle::Sweep(line)", [&](size_t i) { return circles[i].Sweep(velocities[i], lines[i]).time; }));
+	results.push_back(Measure("circle::Sweep(rectangle)", [&](size_t i) { return circles[i].Sweep(velocities[i], rectangles[i]).time; }));
+	results.push_back(Measure("shape::Sweep", [&](size_t i) { return shapes[i].Sweep(velocities[i], shapes[next(i)]).time; }));
+	results.push_back(Measure("shape::SweepPair(circle, circle)", [&](size_t i) { return shape::SweepPair(circles[i], velocities[i], circles[next(i)]).time; }));
+	results.push_back(Measure("Gjk::Contact(rectangle, rectangle)", [&](size_t i) { return Gjk::Contact(rectangles[i], rectangles[next(i)]).depth; }));
+	results.push_back(Measure("Gjk::Contact(convex, convex) cold", [&](size_t i) { return Gjk::Contact(hulls[i], hulls[next(i)]).depth; }));
+	results.push_back(Measure("Gjk::Contact(convex, convex) warm", [&](size_t i) { return Gjk::Contact(hulls[i], hulls[next(i)], &simplices[i]).depth; }));
+	results.push_back(Measure("Gjk::Sweep(circle, convex)", [&](size_t i) { return Gjk::Sweep(circles[i], velocities[i] * k_deltaTime * 10.0f, hulls[i]).time; }));
+
+	GameWorld world(k_deltaTime, k_reverseWindowRatio, k_seed);
+	world.Restart();
+
+	Entity &stick = *world.GetStick1();
+	Entity &puck = *world.GetPuck();
+	const std::vector<line>& borders = world.GetBorders();
+
+	results.push_back(Measure("Entity::Contact(Entity)", [&](size_t i)
+	{
+		stick.SetPosition(points[i]);
+		stick.SetVelocity(velocities[i]);
+		puck.SetPosition(points[next(i)]);
+		puck.SetVelocity(velocities[next(i)]);
+		return stick.Contact(puck).depth;
+	}));
+
+	results.push_back(Measure("Entity::Contact(line)", [&](size_t i)
+	{
+		puck.SetPosition(points[i]);
+		puck.SetVelocity(velocities[i]);
+		return puck.Contact(borders[i % borders.size()]).depth;
+	}));
+
+	results.push_back(Measure("Entity::Collide", [&](size_t i)
+	{
+		stick.SetPosition(points[i]);
+		stick.SetVelocity(velocities[i]);
+		puck.SetPosition(points[i] + glm::vec2(0.05f, 0.05f));
+		puck.SetVelocity(velocities[next(i)]);
+		stick.Collide(puck, contacts[i]);
+		return puck.GetVelocity().x;
+	}));
+
+	results.push_back(Measure("Entity::ReflectFrom", [&](size_t i)
+	{
+		puck.SetPosition(points[i]);
+		puck.SetVelocity(velocities[i]);
+		puck.ReflectFrom(contacts[i], 0.25f);
+		return puck.GetVelocity().x;
+	}));
+
+	const BorderSet& borderSet = world.GetBorderSet();
+	glm::vec2 nearestPoints[BorderSet::k_capacity];
+
+	results.push_back(Measure("BorderSet::TestScalar", [&](size_t i)
+	{
+		return static_cast<float>(borderSet.TestScalar(points[i], circles[i].radius, nearestPoints)) + nearestPoints[0].x;
+	}));
+
+	results.push_back(Measure(BorderSet::IsVectorized() ? "BorderSet::Test (sse2)" : "BorderSet::Test (scalar)", [&](size_t i)
+	{
+		return static_cast<float>(borderSet.Test(points[i], circles[i].radius, nearestPoints)) + nearestPoints[0].x;
+	}));
+
+	results.push_back(Measure("line::Contact(circle) all borders", [&](size_t i)
+	{
+		float sum = 0.0f;
+
+		for (size_t j = 0; j < borders.size(); j++)
+		{
+			sum += borders[j].Contact(circles[i]).depth + borders[j].Nearest(points[i]).x;
+		}
+
+		return sum;
+	}));
+
+	AIController bot(world);
+	bot.SetControlTarget(world.GetStick2());
+	bot.SetMoveForce(8.75f);
+	bot.SetArea(rectangle(glm::vec2(0.5f, 0.75f * k_reverseWindowRatio), glm::vec2(1.0f, k_reverseWindowRatio * 0.54f)));
+	bot.SetPuck(&puck);
+	bot.SetOwnGateRectangle(world.GetGate2()->GetShape().m_data.m_rectangle);
+	bot.SetOpponentGateRectangle(world.GetGate1()->GetShape().m_data.m_rectangle);
+
+	results.push_back(Measure("AIController::Update", [&](size_t i)
+	{
+		puck.SetPosition(points[i]);
+		puck.SetVelocity(velocities[i]);
+		bot.Update();
+		return world.GetStick2()->GetVelocity().x;
+	}));
+
+	return results;
+}
+
+
+bool Benchmark::VerifyBorderSet()
+{
+	Random random;
+
+	GameWorld world(k_deltaTime, k_reverseWindowRatio, k_seed);
+	const BorderSet& borderSet = world.GetBorderSet();
+
+	glm::vec2 vectorPoints[BorderSet::k_capacity];
+	glm::vec2 scalarPoints[BorderSet::k_capacity];
+
+	for (size_t i = 0; i < k_inputCount; i++)
+	{
+		const glm::vec2 center = random.Point();
+		const float radius = random.Range(0.01f, 0.1f);
+
+		const Uint32 vectorMask = borderSet.Test(center, radius, vectorPoints);
+		const Uint32 scalarMask = borderSet.TestScalar(center, radius, scalarPoints);
+
+		bool isEqual = (vectorMask == scalarMask);
+
+		for (size_t j = 0; j < borderSet.GetCount(); j++)
+		{
+			if (!(scalarMask & (1u << j))) { continue; }
+
+			isEqual = isEqual && glm::all(glm::lessThanEqual(glm::abs(vectorPoints[j] - scalarPoints[j]), glm::vec2(k_nearestPointTolerance)));
+		}
+
+		if (!isEqual)
+		{
+			std::cerr << "BorderSet::Test differs from the scalar kernel at (" << center.x << ", " << center.y << "), radius " << radius << "\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool Benchmark::VerifyPhysicsThreads()
+{
+	Uint64 expectedChecksum = 0;
+
+	for (const unsigned int threadCount : k_physicsThreadCounts)
+	{
+		GameWorld world(k_deltaTime, k_reverseWindowRatio, k_seed, k_threadsPuckCount);
+		world.SetAutopilot(true);
+		world.SetPhysicsThreadCount(threadCount);
+
+		for (unsigned int i = 0; i < k_threadsTicks; i++) { world.Step(); }
+
+		const Uint64 checksum = world.GetStateChecksum();
+
+		if (threadCount == k_physicsThreadCounts[0])
+		{
+			expectedChecksum = checksum;
+		}
+		else if (checksum != expectedChecksum)
+		{
+			std::cerr << "World state on " << threadCount << " physics threads differs from " << k_physicsThreadCounts[0] << " after " << k_threadsTicks << " ticks\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool Benchmark::VerifyRevalidation()
+{
+	GameWorld world(k_deltaTime, k_reverseWindowRatio, k_seed, k_revalidationPuckCount);
+	world.SetAutopilot(true);
+
+	const BodyStore& bodies = world.GetBodies();
+	const std::vector<line>& borders = world.GetBorders();
+	const ContactCache& pairs = world.GetNarrowphase().GetContacts();
+	const ContactCache& walls = world.GetWallContacts();
+
+	RevalidationCheck check;
+
+	for (unsigned int i = 0; i < k_revalidationTicks; i++)
+	{
+		world.Step();
+
+		//entries keep where their pair was tested, shapes are moved back there
+		for (const ContactCache::Entry& entry : pairs.GetEntries())
+		{
+			if (!entry.isRevalidated) { continue; }
+
+			shape shape1 = bodies.GetShape(entry.key1);
+			shape shape2 = bodies.GetShape(entry.key2);
+			shape1.Translate(entry.anchor + entry.offset - bodies.positions[entry.key1]);
+			shape2.Translate(entry.anchor - bodies.positions[entry.key2]);
+
+			check.Compare(entry.contact, shape1.Sweep(entry.displacement, shape2), entry.displacement);
+		}
+
+		for (const ContactCache::Entry& entry : walls.GetEntries())
+		{
+			if (!entry.isRevalidated) { continue; }
+
+			shape body = bodies.GetShape(entry.key1);
+			body.Translate(entry.offset - bodies.positions[entry.key1]);
+
+			check.Compare(entry.contact, body.Sweep(entry.displacement, borders[entry.key2]), entry.displacement);
+		}
+	}
+
+	const unsigned long long sustainedCount = pairs.GetSustainedCount() + walls.GetSustainedCount();
+	const unsigned long long revalidatedCount = pairs.GetRevalidatedCount() + walls.GetRevalidatedCount();
+	const double ratio = (sustainedCount > 0) ? static_cast<double>(revalidatedCount) / sustainedCount : 0.0;
+
+	std::cerr << "Sustained contacts revalidated: " << revalidatedCount << " of " << sustainedCount << " (pairs " << pairs.GetRevalidatedCount() << " of " << pairs.GetSustainedCount() << ", walls " << walls.GetRevalidatedCount() << " of " << walls.GetSustainedCount() << ")\n";
+
+	if (ratio < k_minRevalidatedRatio)
+	{
+		std::cerr << "Sustained contacts revalidated below " << k_minRevalidatedRatio << " of the time\n";
+		return false;
+	}
+
+	std::cerr << "Revalidated contacts checked against a full test: " << check.checkedCount << ", normals within " << glm::degrees(glm::acos(glm::min(check.minNormalDot, 1.0f))) << " degrees, contact distances within " << check.maxDistanceError << "\n";
+
+	if (check.mismatchCount > 0)
+	{
+		std::cerr << "Revalidated contacts off a full test: " << check.mismatchCount << "\n";
+		return false;
+	}
+
+	return true;
+}
+
+
+bool Benchmark::VerifySpawnChurn()
+{
+	Random random;
+
+	GameWorld world(k_deltaTime, k_reverseWindowRatio, k_seed, k_churnPuckCount);
+	world.SetAutopilot(true);
+
+	for (unsigned int i = 0; i < k_churnWarmupTicks; i++) { world.Step(); }
+
+	BodyStore& bodies = world.GetBodies();
+	const size_t bodyCount = bodies.GetCount();
+	const glm::vec2* positions = bodies.positions.data();
+	const Entity* entities = &world.GetEntities()[0];
+
+	std::vector<GameWorld::EntityHandle> despawned(k_churnBatch);
+
+	const bool wasEnabled = AllocationTracker::IsEnabled();
+	const Uint64 violationCount = AllocationTracker::GetViolations().count;
+
+	AllocationTracker::SetEnabled(true);
+	AllocationTracker::SetStrict(true);
+
+	bool isStale = true;
+	bool isReused = true;
+
+	for (unsigned int round = 0; round < k_churnRounds; round++)
+	{
+		for (size_t i = 0; i < k_churnBatch; i++)
+		{
+			despawned[i] = world.GetEntityHandle(*world.GetArenaPucks()[random.engine() % world.GetArenaPucks().size()]);
+			world.DespawnEntity(despawned[i]); //picked twice is despawned once
+		}
+
+		world.Step();
+
+		for (const GameWorld::EntityHandle handle : despawned) { isStale = isStale && world.GetEntity(handle) == nullptr; }
+
+		while (world.GetArenaPucks().size() < k_churnPuckCount)
+		{
+			const Entity& puck = world.SpawnArenaPuck(random.Point());
+			isReused = isReused && puck.GetBody() < bodyCount;
+		}
+
+		//slots are taken again by now, handles of their last entities stay stale and despawn nothing
+		for (const GameWorld::EntityHandle handle : despawned)
+		{
+			world.DespawnEntity(handle);
+			isStale = isStale && world.GetEntity(handle) == nullptr;
+		}
+
+		isStale = isStale && world.GetArenaPucks().size() == k_churnPuckCount;
+
+		world.Step();
+	}
+
+	AllocationTracker::SetStrict(false);
+	AllocationTracker::SetEnabled(wasEnabled);
+
+	const Uint64 allocationCount = AllocationTracker::GetViolations().count - violationCount;
+	isReused = isReused && bodies.GetCount() == bodyCount && bodies.positions.data() == positions && &world.GetEntities()[0] == entities;
+
+	if (!isStale) { std::cerr << "Handles of despawned entities still resolve or despawn the entities reusing their slots\n"; }
+	if (!isReused) { std::cerr << "Spawned entities didn't reuse the slots of despawned ones\n"; }
+	if (allocationCount > 0) { std::cerr << "Spawning and despawning allocated " << allocationCount << " times\n"; }
+
+	return isStale && isReused && allocationCount == 0;
+}
+
+
+bool Benchmark::VerifyEvents()
+{
+	struct Probe
+	{
+		Event<void()> event;
+		EventHandle handle;
+		unsigned int calls = 0, otherCalls = 0;
+		bool isAdded = false;
+	};
+
+	bool isValid = true;
+
+	//a listener removing itself is called once, the ones after it still are
+	{
+		Probe probe;
+		Probe* p = &probe;
+
+		probe.handle = probe.event.AddListener([p]() { p->calls++; p->event.RemoveListener(p->handle); });
+		probe.event.AddListener([p]() { p->otherCalls++; });
+
+		probe.event.Invoke();
+		probe.event.Invoke();
+
+		if (probe.calls != 1 || probe.otherCalls != 2)
+		{
+			std::cerr << "Listener removing itself while invoked was called " << probe.calls << " times, the next one " << probe.otherCalls << " times\n";
+			isValid = false;
+		}
+	}
+
+	//a listener added while invoking is called from the next invocation on
+	{
+		Probe probe;
+		Probe* p = &probe;
+
+		probe.event.AddListener([p]()
+		{
+			if (p->isAdded) { return; }
+
+			p->isAdded = true;
+			p->handle = p->event.AddListener([p]() { p->calls++; });
+		});
+
+		probe.event.Invoke();
+		const unsigned int firstCalls = probe.calls;
+		probe.event.Invoke();
+
+		if (firstCalls != 0 || probe.calls != 1)
+		{
+			std::cerr << "Listener added while invoking was called " << firstCalls << " times by that invocation and " << probe.calls - firstCalls << " times by the next one\n";
+			isValid = false;
+		}
+	}
+
+	//the handle of a removed listener doesn't remove the one reusing its slot
+	{
+		Probe probe;
+		Probe* p = &probe;
+
+		const EventHandle staleHandle = probe.event.AddListener([p]() { p->otherCalls++; });
+		probe.event.RemoveListener(staleHandle);
+
+		probe.handle = probe.event.AddListener([p]() { p->calls++; });
+		probe.event.RemoveListener(staleHandle);
+
+		probe.event.Invoke();
+
+		if (probe.handle.index != staleHandle.index || probe.calls != 1 || probe.otherCalls != 0)
+		{
+			std::cerr << "Stale listener handle affected the listener reusing its slot\n";
+			isValid = false;
+		}
+	}
+
+	return isValid;
+}
+
+
+std::string Benchmark::ToJson(const std::vector<Result>& results)
+{
+	std::stringstream stream;
+
+	stream << "{\n\t\"benchmarks\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		stream << "\t\t{ \"name\": \"" << results[i].name << "\", \"ns_per_op\": " << results[i].nanosecondsPerOperation << ", \"ops_per_second\": " << results[i].operationsPerSecond << " }";
+		stream << ((i + 1 < results.size()) ? ",\n" : "\n");
+	}
+
+	stream << "\t]\n}\n";
+
+	return stream.str();
+}
+
+
+std::vector<Benchmark::Result> Benchmark::FromJson(const std::string& json)
+{
+	//reads only what ToJson writes
+	std::vector<Result> results;
+
+	size_t position = 0;
+
+	while ((position = json.find("\"name\": \"", position)) != std::string::npos)
+	{
+		position += 9;
+
+		const size_t nameEnd = json.find('"', position);
+		const size_t timePosition = json.find("\"ns_per_op\": ", nameEnd);
+		if (nameEnd == std::string::npos || timePosition == std::string::npos) { break; }
+
+		Result result;
+		result.name = json.substr(position, nameEnd - position);
+		result.nanosecondsPerOperation = atof(json.c_str() + timePosition + 13);
+		result.operationsPerSecond = result.nanosecondsPerOperation > 0.0 ? 1e9 / result.nanosecondsPerOperation : 0.0;
+
+		results.push_back(result);
+		position = timePosition;
+	}
+
+	return results;
+}
+
+
+bool Benchmark::Compare(const std::vector<Result>& results, const std::vector<Result>& baseline)
+{
+	bool isPassed = true;
+
+	for (const Result& result : results)
+	{
+		const auto previous = std::find_if(baseline.begin(), baseline.end(), [&](const Result& other) { return other.name == result.name; });
+		if (previous == baseline.end() || previous->nanosecondsPerOperation <= 0.0) { continue; }
+
+		const double ratio = result.nanosecondsPerOperation / previous->nanosecondsPerOperation;
+
+		if (ratio > 1.0 + k_regressionThreshold)
+		{
+			std::cerr << "REGRESSION " << result.name << ": " << previous->nanosecondsPerOperation << " -> " << result.nanosecondsPerOperation << " ns/op\n";
+			isPassed = false;
+		}
+		else if (ratio < 1.0 - k_regressionThreshold)
+		{
+			std::cerr << "improvement " << result.name << ": " << previous->nanosecondsPerOperation << " -> " << result.nanosecondsPerOperation << " ns/op\n";
+		}
+	}
+
+	return isPassed;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Settings.h"
+
+
+// microbenchmarks of geometry and collision hot paths; inputs are random
+// but seeded, so numbers are comparable between runs and against a baseline
+
+
+class Benchmark //static
+{
+public:
+	struct Result
+	{
+		std::string name;
+		double nanosecondsPerOperation;
+		double operationsPerSecond;
+	};
+
+	static bool Run(const Settings& settings); //false on regression against baseline, kernel mismatch or io failure
+
+private:
+	static std::vector<Result> RunAll();
+	static bool VerifyBorderSet(); //vector border kernel has to match the scalar one
+	static bool VerifyPhysicsThreads(); //a crowded match has to end up the same on any number of physics threads
+	static bool VerifyRevalidation(); //sustained contacts of a crowded match have to skip their test at times and agree with it when they do
+	static bool VerifySpawnChurn(); //despawned handles go stale, also once their slots are reused without allocating
+	static bool VerifyEvents(); //listeners may add and remove listeners while invoked, stale handles are ignored
+
+	static std::string ToJson(const std::vector<Result>& results);
+	static std::vector<Result> FromJson(const std::string& json);
+
+	static bool Compare(const std::vector<Result>& results, const std::vector<Result>& baseline);
+};
\ No newline at end of file
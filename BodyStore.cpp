@@ -0,0 +1,361 @@
+#include "BodyStore.h"
+
+
+namespace
+{
+	const float kPenetrationRepellingCoefficient = 1.5f;
+
+	const Uint32 k_noShapeIndex = 0xFFFFFFFF;
+}
+
+
+void BodyStore::Reserve(size_t count)
+{
+	positions.reserve(count);
+	previousPositions.reserve(count);
+	velocities.reserve(count);
+	inverseMasses.reserve(count);
+	frictions.reserve(count);
+	shapeTypes.reserve(count);
+	radii.reserve(count);
+	halfSizes.reserve(count);
+	shapeIndices.reserve(count);
+	layerMasks.reserve(count);
+	collisionMasks.reserve(count);
+	flags.reserve(count);
+	restTimes.reserve(count);
+	generations.reserve(count);
+}
+
+
+BodyStore::handle_t BodyStore::Add()
+{
+	const handle_t body = static_cast<handle_t>(positions.size());
+
+	positions.emplace_back();
+	previousPositions.emplace_back();
+	velocities.emplace_back();
+	inverseMasses.emplace_back();
+	frictions.emplace_back();
+	shapeTypes.emplace_back();
+	radii.emplace_back();
+	halfSizes.emplace_back();
+	shapeIndices.emplace_back(k_noShapeIndex);
+	layerMasks.emplace_back();
+	collisionMasks.emplace_back();
+	flags.emplace_back();
+	restTimes.emplace_back();
+	generations.emplace_back(0);
+
+	Reset(body);
+
+	return body;
+}
+
+
+void BodyStore::Reset(handle_t body)
+{
+	positions[body] = glm::vec2(0.0f, 0.0f);
+	previousPositions[body] = glm::vec2(0.0f, 0.0f);
+	velocities[body] = glm::vec2(0.0f, 0.0f);
+	inverseMasses[body] = 0.0f;
+	frictions[body] = 0.0f;
+	shapeTypes[body] = shape::CIRCLE;
+	radii[body] = 0.0f;
+	halfSizes[body] = glm::vec2(0.0f, 0.0f);
+	layerMasks[body] = 0;
+	collisionMasks[body] = 0;
+	flags[body] = ENABLED_FLAG | PHYSICAL_FLAG;
+	restTimes[body] = 0.0f;
+}
+
+
+void BodyStore::SetFlag(handle_t body, Flags flag, bool value)
+{
+	flags[body] = value ? (flags[body] | flag) : (flags[body] & ~flag);
+}
+
+
+void BodyStore::SetPosition(handle_t body, const glm::vec2& position)
+{
+	positions[body] = position;
+	previousPositions[body] = position;
+
+	Wake(body);
+}
+
+
+void BodyStore::SetHull(handle_t body, const hull& outline)
+{
+	if (shapeIndices[body] == k_noShapeIndex)
+	{
+		shapeIndices[body] = static_cast<Uint32>(hulls.size());
+		hulls.emplace_back();
+	}
+
+	shapeTypes[body] = shape::CONVEX;
+	hulls[shapeIndices[body]] = outline;
+}
+
+
+shape BodyStore::GetShape(handle_t body) const
+{
+	shape result;
+	result.m_type = shapeTypes[body];
+
+	switch (result.m_type)
+	{
+		case shape::CIRCLE: result.m_data.m_circle = GetShape<circle>(body); break;
+		case shape::RECTANGLE: result.m_data.m_rectangle = GetShape<rectangle>(body); break;
+		case shape::CONVEX: result.m_data.m_convex = GetShape<convex>(body); break;
+
+		case shape::LINE:
+		case shape::TYPE_COUNT:
+			SDL_assert(false);
+			break;
+	}
+
+	return result;
+}
+
+
+void BodyStore::Bounds(handle_t body, glm::vec2& min, glm::vec2& max) const
+{
+	const glm::vec2& position = positions[body];
+
+	switch (shapeTypes[body])
+	{
+		case shape::CIRCLE:
+		{
+			min = position - radii[body];
+			max = position + radii[body];
+			return;
+		}
+
+		case shape::RECTANGLE:
+		{
+			min = position - halfSizes[body];
+			max = position + halfSizes[body];
+			return;
+		}
+
+		case shape::CONVEX:
+		{
+			hulls[shapeIndices[body]].Bounds(min, max);
+			min += position;
+			max += position;
+			return;
+		}
+
+		case shape::LINE:
+		case shape::TYPE_COUNT:
+			SDL_assert(false);
+			min = max = position;
+			return;
+	}
+}
+
+
+void BodyStore::Integrate(float deltaTime)
+{
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		if (!(flags[i] & ENABLED_FLAG)) { continue; }
+
+		previousPositions[i] = positions[i];
+
+		if (flags[i] & (SLEEPING_FLAG | STATIC_FLAG)) { continue; }
+
+		const glm::vec2 velocity = velocities[i];
+
+		if (glm::dot(velocity, velocity) < k_sleepSpeed * k_sleepSpeed)
+		{
+			restTimes[i] += deltaTime;
+
+			if (restTimes[i] >= k_sleepDelay)
+			{
+				velocities[i] = glm::vec2(0.0f, 0.0f);
+				flags[i] |= SLEEPING_FLAG;
+				continue;
+			}
+		}
+		else
+		{
+			restTimes[i] = 0.0f;
+		}
+
+		if (velocity.x == 0.0f && velocity.y == 0.0f) { continue; }
+
+		const glm::vec2 displacement = velocity * deltaTime;
+		positions[i] += displacement;
+
+		if (frictions[i] > 0.0f)
+		{
+			const float speed = glm::length(velocity);
+			const float slowedSpeed = glm::max(speed - frictions[i] * deltaTime, 0.0f);
+
+			velocities[i] = velocity * (slowedSpeed / speed);
+		}
+	}
+}
+
+
+void BodyStore::Integrate(float deltaTime, unsigned int steps)
+{
+	if (steps == 0) { return; }
+
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		if (!(flags[i] & ENABLED_FLAG)) { continue; }
+
+		if (flags[i] & (SLEEPING_FLAG | STATIC_FLAG))
+		{
+			previousPositions[i] = positions[i];
+			continue;
+		}
+
+		//speed at the start of step j is max(speed - j * slowdown, 0) and the direction never changes
+		const float speed = glm::length(velocities[i]);
+		const float slowdown = frictions[i] * deltaTime;
+
+		//steps starting at or above sleep speed reset the rest time, the rest accumulate it
+		unsigned int fastSteps = steps;
+
+		if (speed < k_sleepSpeed) { fastSteps = 0; } else
+		if (slowdown > 0.0f) { fastSteps = glm::min(steps, static_cast<unsigned int>((speed - k_sleepSpeed) / slowdown) + 1); }
+
+		const float restTime = (fastSteps > 0) ? 0.0f : restTimes[i];
+		const unsigned int slowStepsToSleep = static_cast<unsigned int>(glm::max(ceilf((k_sleepDelay - restTime) / deltaTime), 1.0f));
+		const bool isFallingAsleep = steps - fastSteps >= slowStepsToSleep;
+		const unsigned int awakeSteps = isFallingAsleep ? fastSteps + slowStepsToSleep - 1 : steps;
+
+		unsigned int movingSteps = (speed > 0.0f) ? awakeSteps : 0;
+
+		if (slowdown > 0.0f) { movingSteps = glm::min(movingSteps, static_cast<unsigned int>(ceilf(speed / slowdown))); }
+
+		const glm::vec2 direction = (speed > 0.0f) ? velocities[i] / speed : glm::vec2(0.0f, 0.0f);
+
+		//sum of speeds over the first count moving steps
+		auto distance = [&](unsigned int count)
+		{
+			const float n = static_cast<float>(glm::min(count, movingSteps));
+			return (n * speed - slowdown * n * (n - 1.0f) * 0.5f) * deltaTime;
+		};
+
+		const glm::vec2 displacement = direction * distance(steps);
+
+		previousPositions[i] = positions[i] + direction * distance(steps - 1);
+		positions[i] += displacement;
+
+		if (isFallingAsleep)
+		{
+			velocities[i] = glm::vec2(0.0f, 0.0f);
+			restTimes[i] = restTime + static_cast<float>(slowStepsToSleep) * deltaTime;
+			flags[i] |= SLEEPING_FLAG;
+			continue;
+		}
+
+		velocities[i] = direction * glm::max(speed - slowdown * static_cast<float>(steps), 0.0f);
+		restTimes[i] = restTime + static_cast<float>(steps - fastSteps) * deltaTime;
+	}
+}
+
+
+manifold BodyStore::Contact(handle_t body1, handle_t body2, float deltaTime) const
+{
+	if (!(layerMasks[body1] & collisionMasks[body2])) { return manifold(); }
+
+	return GetShape(body1).Sweep((velocities[body1] - velocities[body2]) * deltaTime, GetShape(body2));
+}
+
+
+manifold BodyStore::Contact(handle_t body, const line& other, float deltaTime) const
+{
+	return GetShape(body).Sweep(velocities[body] * deltaTime, other);
+}
+
+
+void BodyStore::Resolve(handle_t body1, handle_t body2, const manifold& contact)
+{
+	if (!(flags[body1] & PHYSICAL_FLAG) || !(flags[body2] & PHYSICAL_FLAG)) { return; }
+
+	const bool isStatic1 = (flags[body1] & STATIC_FLAG) != 0;
+	const bool isStatic2 = (flags[body2] & STATIC_FLAG) != 0;
+
+	if (isStatic1 && isStatic2) { return; }
+
+	const glm::vec2 normal = -contact.normal; //from the first body towards the second
+	const glm::vec2 tangent = glm::vec2(normal.y, -normal.x); //rotate 90 degrees
+
+	const float normalSpeed1 = glm::dot(velocities[body1], normal);
+	const float tangentSpeed1 = glm::dot(velocities[body1], tangent);
+
+	const float normalSpeed2 = glm::dot(velocities[body2], normal);
+	const float tangentSpeed2 = glm::dot(velocities[body2], tangent);
+
+	if (isStatic1)
+	{
+		velocities[body2] = -normalSpeed2 * normal + tangentSpeed2 * tangent;
+		WakeIfPushed(body2);
+		return;
+	}
+
+	if (isStatic2)
+	{
+		velocities[body1] = -normalSpeed1 * normal + tangentSpeed1 * tangent;
+		WakeIfPushed(body1);
+		return;
+	}
+
+	//elastic collision written with inverse masses: lighter body has larger one
+	const float inverseMass1 = inverseMasses[body1];
+	const float inverseMass2 = inverseMasses[body2];
+	const float inverseMassSum = inverseMass1 + inverseMass2;
+
+	if (inverseMassSum <= 0.0f) { return; }
+
+	const float newNormalSpeed1 = ((inverseMass2 - inverseMass1) * normalSpeed1 + 2.0f * inverseMass1 * normalSpeed2) / inverseMassSum;
+	const float newNormalSpeed2 = ((inverseMass1 - inverseMass2) * normalSpeed2 + 2.0f * inverseMass2 * normalSpeed1) / inverseMassSum;
+
+	const float repellingSpeed = -GetPenetration(contact) * kPenetrationRepellingCoefficient * 0.5f;
+
+	velocities[body1] = (newNormalSpeed1 + repellingSpeed) * normal + tangentSpeed1 * tangent;
+	velocities[body2] = (newNormalSpeed2 - repellingSpeed) * normal + tangentSpeed2 * tangent;
+
+	WakeIfPushed(body1);
+	WakeIfPushed(body2);
+}
+
+
+void BodyStore::Reflect(handle_t body, const manifold& contact, float consumedVelocityRatio)
+{
+	SDL_assert(consumedVelocityRatio >= 0.0f && consumedVelocityRatio <= 1.0f);
+
+	const glm::vec2 normal = -contact.normal; //towards the surface
+	const glm::vec2 tangent(normal.y, -normal.x); //rotate 90 degrees
+
+	const float normalSpeed = glm::dot(velocities[body], normal) * (1.0f - consumedVelocityRatio);
+	const float tangentSpeed = glm::dot(velocities[body], tangent);
+
+	velocities[body] = -normalSpeed * normal + tangentSpeed * tangent;
+}
+
+
+void BodyStore::WakeIfPushed(handle_t body)
+{
+	if (!(flags[body] & SLEEPING_FLAG) || !IsMoving(body)) { return; }
+
+	//even a slow push keeps the momentum it took from the pusher; friction and the rest timer put the body back to sleep
+	Wake(body);
+}
+
+
+void BodyStore::SweptBounds(handle_t body, float deltaTime, glm::vec2& min, glm::vec2& max) const
+{
+	Bounds(body, min, max);
+
+	const glm::vec2 displacement = velocities[body] * deltaTime;
+
+	min = glm::min(min, min + displacement);
+	max = glm::max(max, max + displacement);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+
+#include <SDL.h>
+
+#include <glm/glm.hpp>
+
+#include "Shape.h"
+
+
+// hot physics state of all entities, one array per field, so physics passes
+// stream through only the data they use; entities refer to their body by handle
+
+
+class BodyStore
+{
+public:
+	using handle_t = Uint32;
+
+	enum Flags : Uint8
+	{
+		ENABLED_FLAG = 1 << 0,
+		STATIC_FLAG = 1 << 1,
+		PHYSICAL_FLAG = 1 << 2, //non physical bodies report collisions but don't bounce
+		SLEEPING_FLAG = 1 << 3 //at rest and skipped by physics until a contact, a force or a teleport wakes it
+	};
+
+	static constexpr float k_touchPenetration = 0.0001f; //reported for shapes touching within the step
+	static constexpr float k_sleepSpeed = 0.01f; //playground widths per second
+	static constexpr float k_sleepDelay = 0.5f; //seconds spent slower than k_sleepSpeed before falling asleep
+
+	std::vector<glm::vec2> positions;
+	std::vector<glm::vec2> previousPositions; //before the last integration, for render interpolation
+	std::vector<glm::vec2> velocities;
+	std::vector<float> inverseMasses; //0 is infinite mass
+	std::vector<float> frictions; //speed lost per second
+	std::vector<shape::Type> shapeTypes; //bodies are circles, rectangles or hulls; shapes are made at their positions when queried
+	std::vector<float> radii; //of circles
+	std::vector<glm::vec2> halfSizes; //of rectangles, axis aligned
+	std::vector<Uint32> shapeIndices; //into the pool of the type, for shapes with more data than that
+	std::vector<hull> hulls; //pool of convex bodies
+	std::vector<unsigned int> layerMasks; //to which layers the body belongs
+	std::vector<unsigned int> collisionMasks; //with which layers the body can collide
+	std::vector<Uint8> flags;
+	std::vector<float> restTimes; //seconds spent slower than k_sleepSpeed
+	std::vector<Uint32> generations; //raised when the body is removed, contacts cached with an older one are stale
+
+	void Reserve(size_t count);
+	handle_t Add();
+	void Reset(handle_t body); //back to the state of an added body, for reused handles; keeps the generation
+	inline void Remove(handle_t body) { SetFlag(body, ENABLED_FLAG, false); generations[body]++; } //handle waits to be reused
+
+	inline size_t GetCount() const { return positions.size(); }
+	inline bool IsEnabled(handle_t body) const { return (flags[body] & ENABLED_FLAG) != 0; }
+	inline bool IsMoving(handle_t body) const { return velocities[body].x != 0.0f || velocities[body].y != 0.0f; }
+	inline bool IsStatic(handle_t body) const { return (flags[body] & STATIC_FLAG) != 0; }
+	inline bool IsSleeping(handle_t body) const { return (flags[body] & SLEEPING_FLAG) != 0; }
+	inline bool IsAwake(handle_t body) const { return (flags[body] & (ENABLED_FLAG | STATIC_FLAG | SLEEPING_FLAG)) == ENABLED_FLAG; } //may move this step
+
+	inline void Wake(handle_t body)
+	{
+		flags[body] &= ~SLEEPING_FLAG;
+		restTimes[body] = 0.0f;
+	}
+
+	void SetFlag(handle_t body, Flags flag, bool value);
+	void SetPosition(handle_t body, const glm::vec2& position); //wakes the body
+	void SetHull(handle_t body, const hull& outline); //vertices relative to the position; a body takes a pool slot once
+
+	template <typename type> type GetShape(handle_t body) const; //of the current type only
+	shape GetShape(handle_t body) const;
+	void Bounds(handle_t body, glm::vec2& min, glm::vec2& max) const; //axis aligned
+
+	//moves awake bodies by their velocities, slows them down by friction and puts slow ones to sleep
+	void Integrate(float deltaTime);
+	void Integrate(float deltaTime, unsigned int steps); //same as calling Integrate steps times, in closed form; valid only while nothing collides
+
+	manifold Contact(handle_t body1, handle_t body2, float deltaTime) const;
+	manifold Contact(handle_t body, const line& other, float deltaTime) const;
+
+	//contacts are seen from the first body, as returned by Contact; sleeping bodies wake if pushed at all
+	void Resolve(handle_t body1, handle_t body2, const manifold& contact); //bounce bodies off each other
+	void Reflect(handle_t body, const manifold& contact, float consumedVelocityRatio);
+
+	void SweptBounds(handle_t body, float deltaTime, glm::vec2& min, glm::vec2& max) const;
+
+	inline static float GetPenetration(const manifold& contact) { return contact.isHit ? glm::max(contact.depth, k_touchPenetration) : 0.0f; }
+
+private:
+	void WakeIfPushed(handle_t body);
+};
+
+
+#include "BodyStore.inl"
\ No newline at end of file
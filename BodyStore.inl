@@ -0,0 +1,7 @@
+#pragma once
+
+
+template <> inline line BodyStore::GetShape<line>(handle_t) const { SDL_assert(false); return line(); } //borders are lines, bodies never
+template <> inline circle BodyStore::GetShape<circle>(handle_t body) const { SDL_assert(shapeTypes[body] == shape::CIRCLE); return circle(positions[body], radii[body]); }
+template <> inline rectangle BodyStore::GetShape<rectangle>(handle_t body) const { SDL_assert(shapeTypes[body] == shape::RECTANGLE); return rectangle(positions[body], halfSizes[body] * 2.0f); }
+template <> inline convex BodyStore::GetShape<convex>(handle_t body) const { SDL_assert(shapeTypes[body] == shape::CONVEX); return convex(positions[body], hulls[shapeIndices[body]]); }
\ No newline at end of file
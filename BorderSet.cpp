@@ -0,0 +1,155 @@
+#include "BorderSet.h"
+
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BORDER_SET_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	const size_t k_vectorWidth = 4;
+
+	const float k_farAway = 1e18f; //padding segments sit there, squared distance still fits a float
+}
+
+
+BorderSet::BorderSet() :
+	m_count(0),
+	m_paddedCount(0)
+{}
+
+
+void BorderSet::Build(const std::vector<line>& segments)
+{
+	SDL_assert(segments.size() <= k_capacity);
+
+	m_count = glm::min(segments.size(), k_capacity);
+	m_paddedCount = (m_count + k_vectorWidth - 1) / k_vectorWidth * k_vectorWidth;
+
+	for (size_t i = 0; i < m_paddedCount; i++)
+	{
+		if (i < m_count)
+		{
+			const glm::vec2 edge = segments[i].point2 - segments[i].point1;
+			const float length = glm::length(edge);
+			const glm::vec2 direction = (length > 0.0f) ? edge / length : glm::vec2(1.0f, 0.0f);
+
+			m_x[i] = segments[i].point1.x;
+			m_y[i] = segments[i].point1.y;
+			m_directionX[i] = direction.x;
+			m_directionY[i] = direction.y;
+			m_length[i] = length;
+		}
+		else
+		{
+			m_x[i] = k_farAway;
+			m_y[i] = k_farAway;
+			m_directionX[i] = 1.0f;
+			m_directionY[i] = 0.0f;
+			m_length[i] = 0.0f;
+		}
+	}
+}
+
+
+Uint32 BorderSet::Test(const glm::vec2& center, float radius, glm::vec2* nearestPoints) const
+{
+#ifdef BORDER_SET_SSE2
+	const __m128 centerX = _mm_set1_ps(center.x);
+	const __m128 centerY = _mm_set1_ps(center.y);
+	const __m128 squaredRadius = _mm_set1_ps(radius * radius);
+	const __m128 zero = _mm_setzero_ps();
+
+	alignas(16) float nearestX[k_vectorWidth];
+	alignas(16) float nearestY[k_vectorWidth];
+
+	Uint32 mask = 0;
+
+	for (size_t i = 0; i < m_paddedCount; i += k_vectorWidth)
+	{
+		const __m128 x = _mm_load_ps(m_x + i);
+		const __m128 y = _mm_load_ps(m_y + i);
+		const __m128 directionX = _mm_load_ps(m_directionX + i);
+		const __m128 directionY = _mm_load_ps(m_directionY + i);
+
+		//projection of the center onto the segment, clamped to its ends
+		__m128 projection = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(centerX, x), directionX), _mm_mul_ps(_mm_sub_ps(centerY, y), directionY));
+		projection = _mm_min_ps(_mm_max_ps(projection, zero), _mm_load_ps(m_length + i));
+
+		const __m128 pointX = _mm_add_ps(x, _mm_mul_ps(directionX, projection));
+		const __m128 pointY = _mm_add_ps(y, _mm_mul_ps(directionY, projection));
+
+		const __m128 offsetX = _mm_sub_ps(centerX, pointX);
+		const __m128 offsetY = _mm_sub_ps(centerY, pointY);
+		const __m128 squaredDistance = _mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY));
+
+		const Uint32 hits = static_cast<Uint32>(_mm_movemask_ps(_mm_cmple_ps(squaredDistance, squaredRadius)));
+		mask |= hits << i;
+
+		if (hits != 0 && nearestPoints) //nearest points of missed segments are left untouched
+		{
+			_mm_store_ps(nearestX, pointX);
+			_mm_store_ps(nearestY, pointY);
+
+			for (size_t j = 0; j < k_vectorWidth && i + j < m_count; j++)
+			{
+				if (hits & (1u << j)) { nearestPoints[i + j] = glm::vec2(nearestX[j], nearestY[j]); }
+			}
+		}
+	}
+
+	return mask & ((m_count < 32) ? ((1u << m_count) - 1u) : 0xFFFFFFFFu);
+#else
+	return TestScalar(center, radius, nearestPoints);
+#endif
+}
+
+
+Uint32 BorderSet::TestScalar(const glm::vec2& center, float radius, glm::vec2* nearestPoints) const
+{
+	const float squaredRadius = radius * radius;
+
+	Uint32 mask = 0;
+
+	for (size_t i = 0; i < m_count; i++)
+	{
+		float projection = (center.x - m_x[i]) * m_directionX[i] + (center.y - m_y[i]) * m_directionY[i];
+		projection = glm::min(glm::max(projection, 0.0f), m_length[i]);
+
+		const float pointX = m_x[i] + m_directionX[i] * projection;
+		const float pointY = m_y[i] + m_directionY[i] * projection;
+
+		const float offsetX = center.x - pointX;
+		const float offsetY = center.y - pointY;
+
+		if (offsetX * offsetX + offsetY * offsetY > squaredRadius) { continue; }
+
+		mask |= 1u << i;
+
+		if (nearestPoints) { nearestPoints[i] = glm::vec2(pointX, pointY); }
+	}
+
+	return mask;
+}
+
+
+void BorderSet::Test(const glm::vec2* centers, const float* radii, size_t count, Uint32* masks) const
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		masks[i] = Test(centers[i], radii[i], nullptr);
+	}
+}
+
+
+bool BorderSet::IsVectorized()
+{
+#ifdef BORDER_SET_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include <SDL.h>
+
+#include <glm/glm.hpp>
+
+#include "Line.h"
+
+
+// static border segments laid out one array per field, so a circle is tested
+// against four segments per SSE instruction; scalar code does the same math
+
+
+class BorderSet
+{
+public:
+	static const size_t k_capacity = 32; //segments, one bit of a hit mask each
+
+	BorderSet();
+
+	void Build(const std::vector<line>& segments);
+
+	//bit i is set if segment i is within radius from center; nearest points are written for hit segments only
+	Uint32 Test(const glm::vec2& center, float radius, glm::vec2* nearestPoints) const;
+	Uint32 TestScalar(const glm::vec2& center, float radius, glm::vec2* nearestPoints) const;
+
+	//many circles at once, hit masks only
+	void Test(const glm::vec2* centers, const float* radii, size_t count, Uint32* masks) const;
+
+	inline size_t GetCount() const { return m_count; }
+	static bool IsVectorized();
+
+private:
+	size_t m_count;
+	size_t m_paddedCount; //multiple of vector width, padding segments never hit
+
+	alignas(16) float m_x[k_capacity];
+	alignas(16) float m_y[k_capacity];
+	alignas(16) float m_directionX[k_capacity]; //unit
+	alignas(16) float m_directionY[k_capacity];
+	alignas(16) float m_length[k_capacity];
+};
\ No newline at end of file
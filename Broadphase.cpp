@@ -0,0 +1,181 @@
+#include "Broadphase.h"
+
+#include <algorithm>
+
+
+Broadphase::Broadphase(const CollisionMatrix& collisionMatrix) :
+	m_collisionMatrix(collisionMatrix),
+	m_orders(collisionMatrix.GetLayerCount())
+{}
+
+
+size_t Broadphase::Add(Uint32 key, size_t layer)
+{
+	SDL_assert(layer < m_orders.size());
+
+	const size_t proxy = m_keys.size();
+
+	m_bounds.push_back({ 0.0f, 0.0f, 0.0f, 0.0f });
+	m_keys.push_back(key);
+	m_isEnabled.push_back(true);
+	m_layers.push_back(layer);
+	m_orders[layer].push_back(static_cast<Uint32>(proxy));
+
+	return proxy;
+}
+
+
+void Broadphase::Reserve(size_t proxyCount, size_t pairCount)
+{
+	m_bounds.reserve(proxyCount);
+	m_keys.reserve(proxyCount);
+	m_isEnabled.reserve(proxyCount);
+	m_layers.reserve(proxyCount);
+	m_pairs.reserve(pairCount);
+}
+
+
+void Broadphase::Update(size_t proxy, const glm::vec2& min, const glm::vec2& max)
+{
+	m_bounds[proxy] = { min.x, max.x, min.y, max.y };
+}
+
+
+void Broadphase::SetEnabled(size_t proxy, bool enabled)
+{
+	m_isEnabled[proxy] = enabled;
+}
+
+
+void Broadphase::SetLayer(size_t proxy, size_t layer)
+{
+	SDL_assert(layer < m_orders.size());
+
+	if (m_layers[proxy] == layer) { return; }
+
+	std::vector<Uint32>& order = m_orders[m_layers[proxy]];
+	order.erase(std::find(order.begin(), order.end(), static_cast<Uint32>(proxy)));
+
+	m_orders[layer].push_back(static_cast<Uint32>(proxy));
+	m_layers[proxy] = layer;
+}
+
+
+const std::vector<Broadphase::Pair>& Broadphase::FindPairs()
+{
+	m_pairs.clear();
+
+	for (std::vector<Uint32>& order : m_orders)
+	{
+		Sort(order);
+	}
+
+	for (size_t i = 0; i < m_orders.size(); i++)
+	{
+		if (m_orders[i].empty()) { continue; }
+
+		if (m_collisionMatrix.CanCollide(i, i)) { Sweep(m_orders[i]); }
+
+		for (size_t j = i + 1; j < m_orders.size(); j++)
+		{
+			if (!m_orders[j].empty() && m_collisionMatrix.CanCollide(i, j)) { Sweep(m_orders[i], m_orders[j]); }
+		}
+	}
+
+	//same order as a nested loop over keys would give, whatever the sweep order was
+	std::sort(m_pairs.begin(), m_pairs.end(), [](const Pair& pair1, const Pair& pair2)
+	{
+		return (pair1.key1 != pair2.key1) ? (pair1.key1 < pair2.key1) : (pair1.key2 < pair2.key2);
+	});
+
+	return m_pairs;
+}
+
+
+void Broadphase::Sort(std::vector<Uint32>& order)
+{
+	for (size_t i = 1; i < order.size(); i++)
+	{
+		const Uint32 proxy = order[i];
+		const float minX = m_bounds[proxy].minX;
+
+		size_t j = i;
+
+		while (j > 0 && m_bounds[order[j - 1]].minX > minX)
+		{
+			order[j] = order[j - 1];
+			j--;
+		}
+
+		order[j] = proxy;
+	}
+}
+
+
+void Broadphase::Sweep(const std::vector<Uint32>& order)
+{
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		const Uint32 proxy1 = order[i];
+		if (!m_isEnabled[proxy1]) { continue; }
+
+		const float maxX = m_bounds[proxy1].maxX;
+
+		for (size_t j = i + 1; j < order.size() && m_bounds[order[j]].minX <= maxX; j++)
+		{
+			Test(proxy1, order[j]);
+		}
+	}
+}
+
+
+void Broadphase::Sweep(const std::vector<Uint32>& order1, const std::vector<Uint32>& order2)
+{
+	size_t i = 0;
+	size_t j = 0;
+
+	//the proxy starting first is tested against the other layer's proxies starting before it ends
+	while (i < order1.size() && j < order2.size())
+	{
+		if (m_bounds[order1[i]].minX <= m_bounds[order2[j]].minX)
+		{
+			const Uint32 proxy1 = order1[i++];
+			if (!m_isEnabled[proxy1]) { continue; }
+
+			const float maxX = m_bounds[proxy1].maxX;
+
+			for (size_t k = j; k < order2.size() && m_bounds[order2[k]].minX <= maxX; k++)
+			{
+				Test(proxy1, order2[k]);
+			}
+		}
+		else
+		{
+			const Uint32 proxy2 = order2[j++];
+			if (!m_isEnabled[proxy2]) { continue; }
+
+			const float maxX = m_bounds[proxy2].maxX;
+
+			for (size_t k = i; k < order1.size() && m_bounds[order1[k]].minX <= maxX; k++)
+			{
+				Test(proxy2, order1[k]);
+			}
+		}
+	}
+}
+
+
+void Broadphase::Test(Uint32 proxy1, Uint32 proxy2)
+{
+	if (!m_isEnabled[proxy2]) { return; }
+
+	const Bounds& bounds1 = m_bounds[proxy1];
+	const Bounds& bounds2 = m_bounds[proxy2];
+
+	if (bounds2.minY > bounds1.maxY || bounds2.maxY < bounds1.minY) { return; }
+
+	const Uint32 key1 = m_keys[proxy1];
+	const Uint32 key2 = m_keys[proxy2];
+
+	m_pairs.push_back(key1 < key2 ? Pair{ key1, key2 } : Pair{ key2, key1 });
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+#include <SDL.h>
+
+#include <glm/glm.hpp>
+
+#include "CollisionMatrix.h"
+
+
+// sweep and prune along x: proxies stay sorted between ticks, so restoring the
+// order after small moves with insertion sort is close to linear; every layer
+// has its own order and only layers allowed by the collision matrix are swept
+
+
+class Broadphase
+{
+public:
+	struct Pair
+	{
+		Uint32 key1, key2; //key1 < key2
+	};
+
+	explicit Broadphase(const CollisionMatrix& collisionMatrix);
+
+	//key identifies the proxy in reported pairs, pairs are ordered by keys
+	size_t Add(Uint32 key, size_t layer);
+	void Reserve(size_t proxyCount, size_t pairCount);
+
+	void Update(size_t proxy, const glm::vec2& min, const glm::vec2& max);
+	void SetEnabled(size_t proxy, bool enabled);
+	void SetLayer(size_t proxy, size_t layer); //for reused keys; the proxy is sorted into its new layer on the next search
+
+	//overlapping enabled proxies of layers that collide
+	const std::vector<Pair>& FindPairs();
+
+	inline size_t GetProxyCount() const { return m_keys.size(); }
+
+private:
+	struct Bounds
+	{
+		float minX, maxX, minY, maxY;
+	};
+
+	CollisionMatrix m_collisionMatrix;
+
+	std::vector<Bounds> m_bounds;
+	std::vector<Uint32> m_keys;
+	std::vector<bool> m_isEnabled;
+	std::vector<size_t> m_layers;
+
+	std::vector<std::vector<Uint32>> m_orders; //proxies of every layer by minX, kept from the previous tick
+	std::vector<Pair> m_pairs;
+
+	void Sort(std::vector<Uint32>& order);
+
+	void Sweep(const std::vector<Uint32>& order); //pairs within one layer
+	void Sweep(const std::vector<Uint32>& order1, const std::vector<Uint32>& order2); //pairs across two layers
+
+	void Test(Uint32 proxy1, Uint32 proxy2); //proxies overlap along x
+};
\ No newline at end of file
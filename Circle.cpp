@@ -4,6 +4,73 @@
 #include "Rectangle.h"
 
 
+namespace
+{
+	//earliest time in [0; 1] when the moving point enters the circle, negative if it doesn't
+	float RayCircle(const glm::vec2 &point, const glm::vec2 &displacement, const glm::vec2 &center, float radius)
+	{
+		const glm::vec2 offset = point - center;
+
+		const float a = glm::dot(displacement, displacement);
+		const float halfB = glm::dot(offset, displacement);
+		const float c = glm::dot(offset, offset) - radius * radius;
+
+		if (a <= 0.0f || halfB >= 0.0f) { return -1.0f; } //not moving or moving away
+
+		const float discriminant = halfB * halfB - a * c;
+		if (discriminant < 0.0f) { return -1.0f; }
+
+		const float time = (-halfB - sqrtf(discriminant)) / a;
+
+		return (time <= 1.0f) ? glm::max(time, 0.0f) : -1.0f;
+	}
+
+
+	//moving point against segment inflated by radius; point must start outside of it
+	manifold SweepCapsule(const glm::vec2 &point, const glm::vec2 &displacement, const glm::vec2 &point1, const glm::vec2 &point2, float radius)
+	{
+		const glm::vec2 edge = point2 - point1;
+		const float edgeLengthSquared = glm::dot(edge, edge);
+
+		if (edgeLengthSquared > 0.0f)
+		{
+			glm::vec2 normal = glm::vec2(-edge.y, edge.x) / sqrtf(edgeLengthSquared);
+			float distance = glm::dot(point - point1, normal);
+
+			if (distance < 0.0f)
+			{
+				normal = -normal;
+				distance = -distance;
+			}
+
+			const float approachSpeed = -glm::dot(displacement, normal);
+
+			if (distance >= radius && approachSpeed > 0.0f)
+			{
+				const float time = (distance - radius) / approachSpeed;
+
+				if (time <= 1.0f)
+				{
+					const float projection = glm::dot(point + displacement * time - point1, edge);
+					if (projection >= 0.0f && projection <= edgeLengthSquared) { return manifold(time, normal, 0.0f, point1 + edge * (projection / edgeLengthSquared)); }
+				}
+			}
+		}
+
+		//flat side is missed, so the capsule can only be entered through one of its caps
+		manifold result;
+
+		const float time1 = RayCircle(point, displacement, point1, radius);
+		if (time1 >= 0.0f) { result = manifold(time1, glm::normalize(point + displacement * time1 - point1), 0.0f, point1); }
+
+		const float time2 = RayCircle(point, displacement, point2, radius);
+		if (time2 >= 0.0f && (time1 < 0.0f || time2 < time1)) { result = manifold(time2, glm::normalize(point + displacement * time2 - point2), 0.0f, point2); }
+
+		return result;
+	}
+}
+
+
 circle::circle():
 	position(0.0f, 0.0f),
 	radius(1.0f)
@@ -16,19 +83,114 @@ circle::circle(const glm::vec2 &center, float radius):
 {}
 
 
-float circle::Contact(const line &other) const
+manifold circle::Contact(const line &other) const
 {
-	return other.Contact(*this);
+	const glm::vec2 nearest = other.Nearest(position);
+	const glm::vec2 offset = position - nearest;
+	const float squaredDistance = glm::dot(offset, offset);
+
+	if (squaredDistance > radius * radius) { return manifold(); }
+
+	const float distance = sqrtf(squaredDistance);
+	const glm::vec2 normal = (distance > 0.0f) ? offset / distance : glm::vec2(0.0f, 1.0f);
+
+	return manifold(0.0f, normal, radius - distance, nearest);
 }
 
 
-float circle::Contact(const circle &other) const
+manifold circle::Contact(const circle &other) const
 {
-	return (radius + other.radius) - glm::distance(position, other.position);
+	const glm::vec2 offset = position - other.position;
+	const float squaredDistance = glm::dot(offset, offset);
+	const float radiusSum = radius + other.radius;
+
+	if (squaredDistance > radiusSum * radiusSum) { return manifold(); }
+
+	const float distance = sqrtf(squaredDistance);
+	const glm::vec2 normal = (distance > 0.0f) ? offset / distance : glm::vec2(0.0f, 1.0f);
+
+	return manifold(0.0f, normal, radiusSum - distance, other.position + normal * other.radius);
 }
 
 
-float circle::Contact(const rectangle &other) const
+manifold circle::Contact(const rectangle &other) const
 {
-	return other.Contact(*this);
+	const glm::vec2 local = other.ToLocal(position);
+	const glm::vec2 clamped = glm::clamp(local, -other.halfSize, other.halfSize);
+	const glm::vec2 outside = local - clamped;
+	const float squaredDistance = glm::dot(outside, outside);
+
+	if (squaredDistance > radius * radius) { return manifold(); }
+
+	if (squaredDistance > 0.0f)
+	{
+		const float distance = sqrtf(squaredDistance);
+
+		return manifold(0.0f, (other.direction1 * outside.x + other.direction2 * outside.y) / distance, radius - distance, other.ToWorld(clamped));
+	}
+
+	//center is inside, push out through the nearest side
+	const float depth1 = other.halfSize.x - glm::abs(local.x);
+	const float depth2 = other.halfSize.y - glm::abs(local.y);
+
+	if (depth1 < depth2)
+	{
+		const float side = (local.x < 0.0f) ? -1.0f : 1.0f;
+		return manifold(0.0f, other.direction1 * side, radius + depth1, other.ToWorld(glm::vec2(side * other.halfSize.x, local.y)));
+	}
+
+	const float side = (local.y < 0.0f) ? -1.0f : 1.0f;
+	return manifold(0.0f, other.direction2 * side, radius + depth2, other.ToWorld(glm::vec2(local.x, side * other.halfSize.y)));
+}
+
+
+manifold circle::Sweep(const glm::vec2 &displacement, const line &other) const
+{
+	const manifold overlap = Contact(other);
+	if (overlap.isHit) { return overlap; }
+
+	return SweepCapsule(position, displacement, other.point1, other.point2, radius);
+}
+
+
+manifold circle::Sweep(const glm::vec2 &displacement, const circle &other) const
+{
+	const manifold overlap = Contact(other);
+	if (overlap.isHit) { return overlap; }
+
+	const float time = RayCircle(position, displacement, other.position, radius + other.radius);
+	if (time < 0.0f) { return manifold(); }
+
+	const glm::vec2 normal = glm::normalize(position + displacement * time - other.position);
+
+	return manifold(time, normal, 0.0f, other.position + normal * other.radius);
+}
+
+
+manifold circle::Sweep(const glm::vec2 &displacement, const rectangle &other) const
+{
+	const manifold overlap = Contact(other);
+	if (overlap.isHit) { return overlap; }
+
+	//the rounded rectangle is entered through one of the capsules around its edges
+	const glm::vec2 axis1 = other.Axis1();
+	const glm::vec2 axis2 = other.Axis2();
+
+	const glm::vec2 corner1 = other.position + axis1 + axis2;
+	const glm::vec2 corner2 = other.position + axis1 - axis2;
+	const glm::vec2 corner3 = other.position - axis1 - axis2;
+	const glm::vec2 corner4 = other.position - axis1 + axis2;
+
+	manifold result = SweepCapsule(position, displacement, corner1, corner2, radius);
+
+	const manifold hit2 = SweepCapsule(position, displacement, corner2, corner3, radius);
+	if (hit2.IsEarlierThan(result)) { result = hit2; }
+
+	const manifold hit3 = SweepCapsule(position, displacement, corner3, corner4, radius);
+	if (hit3.IsEarlierThan(result)) { result = hit3; }
+
+	const manifold hit4 = SweepCapsule(position, displacement, corner4, corner1, radius);
+	if (hit4.IsEarlierThan(result)) { result = hit4; }
+
+	return result;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include "Manifold.h"
+
 
 struct line;
 struct circle;
@@ -16,7 +18,17 @@ struct circle final
 	circle();
 	circle(const glm::vec2 &center, float radius);
 
-	float Contact(const line &other) const;
-	float Contact(const circle &other) const;
-	float Contact(const rectangle &other) const;
+	manifold Contact(const line &other) const;
+	manifold Contact(const circle &other) const;
+	manifold Contact(const rectangle &other) const;
+
+	//exact time of impact when moving by displacement relative to the other shape
+	manifold Sweep(const glm::vec2 &displacement, const line &other) const;
+	manifold Sweep(const glm::vec2 &displacement, const circle &other) const;
+	manifold Sweep(const glm::vec2 &displacement, const rectangle &other) const;
+
+	//support mapping for general convex queries, a point with the radius as margin
+	inline int Support(const glm::vec2&) const { return 0; }
+	inline glm::vec2 Vertex(int) const { return position; }
+	inline float Margin() const { return radius; }
 };
\ No newline at end of file
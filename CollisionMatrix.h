@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+
+
+// which layers collide with which, built at compile time from the collision
+// mask of every layer; layer index is the bit position of its layer mask
+
+
+class CollisionMatrix
+{
+public:
+	static const size_t k_maxLayers = 32;
+
+	template <size_t count>
+	constexpr CollisionMatrix(const unsigned int (&collisionMasks)[count]) :
+		m_rows(),
+		m_layerCount(count)
+	{
+		static_assert(count <= k_maxLayers, "Too many layers for a collision matrix");
+
+		for (size_t i = 0; i < count; i++)
+		{
+			m_rows[i] = collisionMasks[i];
+		}
+	}
+
+	inline constexpr size_t GetLayerCount() const { return m_layerCount; }
+	inline constexpr unsigned int GetRow(size_t layer) const { return m_rows[layer]; } //mask of layers colliding with that one
+
+	inline constexpr bool CanCollide(size_t layer1, size_t layer2) const { return ((m_rows[layer1] >> layer2) & 1u) != 0; }
+
+	//masks agree both ways, so pairs can be visited in any order
+	inline constexpr bool IsSymmetric() const
+	{
+		for (size_t i = 0; i < m_layerCount; i++)
+		{
+			for (size_t j = 0; j < m_layerCount; j++)
+			{
+				if (CanCollide(i, j) != CanCollide(j, i)) { return false; }
+			}
+		}
+
+		return true;
+	}
+
+	inline static constexpr size_t LayerOf(unsigned int layerMask)
+	{
+		size_t layer = 0;
+
+		while (layer < k_maxLayers && !((layerMask >> layer) & 1u)) { layer++; }
+
+		return layer;
+	}
+
+private:
+	unsigned int m_rows[k_maxLayers];
+	size_t m_layerCount;
+};
\ No newline at end of file
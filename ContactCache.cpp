@@ -0,0 +1,123 @@
+#include "ContactCache.h"
+
+
+namespace
+{
+	const float k_revalidationSlop = 0.001f; //a contact slid less than that along itself keeps its normal within a few degrees, in playground widths
+	const float k_revalidationMargin = 0.0001f; //sliding within the slop rounds shapes apart by less, contacts closer to touching get a full test
+	const float k_revalidationMaxDepth = 0.005f; //deeper overlaps may have passed the middle of a shape, where the normal flips
+
+	//sliding along the contact turns its normal
+	inline bool IsAlong(const glm::vec2& drift, const glm::vec2& normal) { return glm::length(drift - normal * glm::dot(drift, normal)) <= k_revalidationSlop; }
+}
+
+
+void ContactCache::Reserve(size_t count)
+{
+	m_entries.reserve(count);
+	m_previousEntries.reserve(count);
+}
+
+
+void ContactCache::Begin()
+{
+	m_previousEntries.swap(m_entries);
+	m_entries.clear();
+}
+
+
+ContactCache::Entry& ContactCache::Track(std::vector<Entry>& entries, Uint32 key1, Uint32 key2, Uint32 generation, const glm::vec2& offset, const glm::vec2& displacement, const glm::vec2& anchor) const
+{
+	entries.emplace_back();
+
+	Entry& entry = entries.back();
+	entry.key1 = key1;
+	entry.key2 = key2;
+	entry.generation = generation;
+	entry.offset = offset;
+	entry.displacement = displacement;
+	entry.anchor = anchor;
+	entry.wasHit = false;
+	entry.isRevalidated = false;
+
+	const Entry* previous = FindPrevious(key1, key2);
+	if (!previous || previous->generation != generation) { return entry; } //new pairs start cold
+
+	entry.simplex = previous->simplex;
+	entry.wasHit = previous->contact.isHit;
+	entry.contact = previous->contact;
+	entry.contact.point += anchor - previous->anchor;
+
+	//same relative state gives the same contact, only carried along with the shapes
+	entry.isRevalidated = previous->contact.isHit ? Revalidate(*previous, entry) : (previous->offset == offset && previous->displacement == displacement);
+
+	return entry;
+}
+
+
+void ContactCache::Add(const std::vector<Entry>& entries)
+{
+	m_entries.insert(m_entries.end(), entries.begin(), entries.end());
+}
+
+
+bool ContactCache::Revalidate(const Entry& previous, Entry& entry)
+{
+	const glm::vec2 normal = previous.contact.normal;
+
+	//measured from the last full test, so slides of a run of revalidated ticks don't add up;
+	//a swept contact holds where the shapes touched, not where they started the tick
+	if (previous.isRevalidated)
+	{
+		entry.testedOffset = previous.testedOffset;
+		entry.testedGap = previous.testedGap;
+	}
+	else
+	{
+		entry.testedOffset = previous.offset + previous.displacement * previous.contact.time;
+		entry.testedGap = -previous.contact.depth;
+	}
+
+	const glm::vec2 drift = entry.offset - entry.testedOffset;
+	const float gap = entry.testedGap + glm::dot(drift, normal);
+	const float approach = glm::dot(entry.displacement, normal);
+
+	//past some depth the shapes may have passed the middle of one another, where the normal flips
+	if (gap < -k_revalidationMaxDepth) { return false; }
+
+	if (previous.offset == entry.offset && previous.displacement == entry.displacement) { return true; }
+
+	if (gap <= -k_revalidationMargin) //still overlapping
+	{
+		if (!IsAlong(drift, normal)) { return false; }
+
+		entry.contact.time = 0.0f;
+		entry.contact.depth = -gap;
+		return true;
+	}
+
+	//closing in again along the normal and reaching the contact within the tick
+	if (gap > 0.0f && approach < 0.0f && gap + approach <= -k_revalidationMargin)
+	{
+		if (!IsAlong(drift, normal) || !IsAlong(entry.displacement, normal)) { return false; }
+
+		entry.contact.time = gap / -approach;
+		entry.contact.depth = 0.0f;
+		return true;
+	}
+
+	return false; //touching barely or separating pairs get a full test
+}
+
+
+const ContactCache::Entry* ContactCache::FindPrevious(Uint32 key1, Uint32 key2) const
+{
+	Entry key;
+	key.key1 = key1;
+	key.key2 = key2;
+
+	const std::vector<Entry>::const_iterator previous = std::lower_bound(m_previousEntries.begin(), m_previousEntries.end(), key);
+	const bool isFound = previous != m_previousEntries.end() && previous->key1 == key1 && previous->key2 == key2;
+
+	return isFound ? &*previous : nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include <SDL.h>
+#include <glm/glm.hpp>
+
+#include "Gjk.h"
+#include "Manifold.h"
+
+
+// contacts of the last tick by pair of keys. A pair touching again is a persisting
+// contact, its manifold is reused as long as the pair only moved along the contact
+// normal by less than a slop since it was last tested and clearly overlaps or reaches
+// it within the tick. Pairs starting, still or stopping to touch are reported at
+// the end of the tick.
+// Entries carry a generation of their keys, an entry of an older one is stale:
+// its pair starts cold and isn't reported as ended
+
+
+class ContactCache
+{
+public:
+	enum Phase { BEGIN, PERSIST, END };
+
+	struct Entry
+	{
+		Uint32 key1, key2;
+		Uint32 generation; //of the keys when tracked
+		glm::vec2 offset, displacement; //relative position and motion of this tick
+		glm::vec2 testedOffset; //relative position of the last full test of a revalidated contact
+		float testedGap; //separation along the normal there, negative when overlapping
+		glm::vec2 anchor; //position of the second shape, contact points move along with it
+		manifold contact; //the last one until tested again
+		Gjk::Simplex simplex;
+		bool wasHit; //touching the last tick
+		bool isRevalidated; //contact is the last one, no test needed
+
+		inline bool operator<(const Entry& other) const { return (key1 != other.key1) ? key1 < other.key1 : key2 < other.key2; }
+	};
+
+	void Reserve(size_t count);
+	void Begin(); //current contacts become the last ones
+
+	//entry of this tick, carrying over what the last tick found for the pair; valid until the next call
+	inline Entry& Track(Uint32 key1, Uint32 key2, Uint32 generation, const glm::vec2& offset, const glm::vec2& displacement, const glm::vec2& anchor) { return Track(m_entries, key1, key2, generation, offset, displacement, anchor); }
+
+	//same into a list of the caller, so several threads can track pairs at once; the list is added before End
+	Entry& Track(std::vector<Entry>& entries, Uint32 key1, Uint32 key2, Uint32 generation, const glm::vec2& offset, const glm::vec2& displacement, const glm::vec2& anchor) const;
+	void Add(const std::vector<Entry>& entries);
+
+	//callback(entry, phase) for contacts of this tick that began or persisted and for last ones not touching anymore, by keys;
+	//generation(key1, key2) is the current generation of a pair, last contacts of an older one are dropped unreported
+	template <typename Generation, typename Callback> void End(Generation generation, Callback callback);
+
+	inline size_t GetCount() const { return m_entries.size(); }
+	inline const std::vector<Entry>& GetEntries() const { return m_entries; } //of this tick, by keys once ended
+	inline unsigned long long GetSustainedCount() const { return m_sustainedCount; } //contacts still touching after moving, since the start
+	inline unsigned long long GetRevalidatedCount() const { return m_revalidatedCount; } //of them, the ones no test was needed for
+
+private:
+	std::vector<Entry> m_entries, m_previousEntries; //previous ones sorted by keys
+	unsigned long long m_sustainedCount = 0, m_revalidatedCount = 0;
+
+	const Entry* FindPrevious(Uint32 key1, Uint32 key2) const;
+	static bool Revalidate(const Entry& previous, Entry& entry);
+};
+
+
+#include "ContactCache.inl"
\ No newline at end of file
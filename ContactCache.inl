@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+
+
+template <typename Generation, typename Callback>
+void ContactCache::End(Generation generation, Callback callback)
+{
+	std::sort(m_entries.begin(), m_entries.end());
+
+	std::vector<Entry>::const_iterator previous = m_previousEntries.begin();
+
+	for (const Entry& entry : m_entries)
+	{
+		//last contacts ordered before this entry were not tracked again
+		for (; previous != m_previousEntries.end() && *previous < entry; previous++)
+		{
+			if (previous->contact.isHit && previous->generation == generation(previous->key1, previous->key2)) { callback(*previous, END); }
+		}
+
+		const bool isTracked = previous != m_previousEntries.end() && !(entry < *previous);
+
+		if (isTracked)
+		{
+			if (previous->contact.isHit && previous->generation == entry.generation && !entry.contact.isHit) { callback(*previous, END); }
+
+			if (entry.wasHit && entry.contact.isHit && (entry.offset != previous->offset || entry.displacement != previous->displacement))
+			{
+				m_sustainedCount++;
+				if (entry.isRevalidated) { m_revalidatedCount++; }
+			}
+
+			previous++;
+		}
+
+		if (entry.contact.isHit) { callback(entry, entry.wasHit ? PERSIST : BEGIN); }
+	}
+
+	for (; previous != m_previousEntries.end(); previous++)
+	{
+		if (previous->contact.isHit && previous->generation == generation(previous->key1, previous->key2)) { callback(*previous, END); }
+	}
+}
\ No newline at end of file
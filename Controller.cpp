@@ -1,9 +1,7 @@
-#include <chrono>
-
 #include "Controller.h"
 
-#include "Game.h"
 #include "Entity.h"
+#include "GameWorld.h"
 
 
 namespace
@@ -22,12 +20,12 @@ namespace
 }
 
 
-KeyboardController::KeyboardController() :
+KeyboardController::KeyboardController(GameWorld& world) :
+	Controller(world),
 	m_down(SDL_Scancode::SDL_SCANCODE_DOWN),
 	m_left(SDL_Scancode::SDL_SCANCODE_LEFT),
 	m_right(SDL_Scancode::SDL_SCANCODE_RIGHT),
 	m_up(SDL_Scancode::SDL_SCANCODE_UP),
-	m_moveDirection(0.0f, 0.0f),
 	m_moveDown(false),
 	m_moveLeft(false),
 	m_moveRight(false),
@@ -54,6 +52,22 @@ void KeyboardController::Update()
 }
 
 
+unsigned int KeyboardController::GetIdleTicks() const
+{
+	if (GetKeyState() != 0) { return 0; }
+
+	//released keys push only a stick that leaves own area
+	const glm::vec2 local = m_ownArea.ToLocal(m_controlTarget->GetPosition());
+	const glm::vec2 margin = m_ownArea.halfSize - glm::abs(local);
+	const float speed = glm::length(m_controlTarget->GetVelocity());
+
+	const float idleTime = (speed > 0.0f) ? glm::min(margin.x, margin.y) / speed : INFINITY;
+	const float idleTicks = floorf(idleTime / m_world->deltaTime) - 1.0f;
+
+	return (idleTicks > 0.0f) ? static_cast<unsigned int>(glm::min(idleTicks, 1e6f)) : 0;
+}
+
+
 void KeyboardController::OnKeyboardDown(SDL_Scancode sdlScancode)
 {
 	if (m_down == sdlScancode) { m_moveDown = true; } else
@@ -72,13 +86,26 @@ void KeyboardController::OnKeyboardUp(SDL_Scancode sdlScancode)
 }
 
 
+Uint8 KeyboardController::GetKeyState() const
+{
+	return m_moveDown | (m_moveLeft << 1) | (m_moveRight << 2) | (m_moveUp << 3);
+}
+
+
+void KeyboardController::SetKeyState(Uint8 state)
+{
+	m_moveDown = (state & 0b0001) != 0;
+	m_moveLeft = (state & 0b0010) != 0;
+	m_moveRight = (state & 0b0100) != 0;
+	m_moveUp = (state & 0b1000) != 0;
+}
+
+
 glm::vec2 KeyboardController::GetDirection() const
 {
 	const float SQRT2 = 0.70710678118f;
 
-	const unsigned char directionCode = m_moveDown | (m_moveLeft << 1) | (m_moveRight << 2) | (m_moveUp << 3);
-
-	switch (directionCode)
+	switch (GetKeyState())
 	{
 		case 0b0001: return glm::vec2(0.0f, -1.0f);
 		case 0b0010: return glm::vec2(-1.0f, 0.0f);
@@ -97,13 +124,22 @@ glm::vec2 KeyboardController::GetDirection() const
 }
 
 
-AIController::AIController()
+AIController::AIController(GameWorld& world) :
+	Controller(world),
+	m_puck(nullptr),
+	m_remainingWaiting(0.0f)
 {
-	srand(std::chrono::steady_clock::now().time_since_epoch().count());
-	m_gateGuardPointPhase = 0.001f * (rand() % 1000);
+	m_gateGuardPointPhase = 0.001f * (m_world->Random() % 1000);
+
+	m_nextRoundListener = m_world->m_onNextRound.AddListener([this]() { OnNextRound(); });
+	m_puckCollisionListener = m_world->m_onPuckCollision.AddListener([this](Entity::mask_t) { OnPuckCollision(); });
+}
 
-	Game::s_onNextRound.AddListener([this]() { OnNextRound(); });
-	Game::s_onPuckCollision.AddListener([this]() { OnPuckCollision(); });
+
+AIController::~AIController()
+{
+	m_world->m_onNextRound.RemoveListener(m_nextRoundListener);
+	m_world->m_onPuckCollision.RemoveListener(m_puckCollisionListener);
 }
 
 
@@ -111,7 +147,7 @@ void AIController::Update()
 {
 	glm::vec2 moveDirection(0.0f, 0.0f);
 
-	m_remainingWaiting = fmaxf(m_remainingWaiting - Game::deltaTime, 0.0f);
+	m_remainingWaiting = fmaxf(m_remainingWaiting - m_world->deltaTime, 0.0f);
 
 	if (m_remainingWaiting <= 0.0f && m_puck->IsEnabled() && m_ownArea.Contain(m_puck->GetPosition()))
 	{
@@ -141,13 +177,10 @@ void AIController::Update()
 	
 	if(moveDirection.x == 0.0f && moveDirection.y == 0.0f)
 	{
-		m_gateGuardPointPhase += Game::deltaTime * k_reverseGuardPointChangePeriod;
+		m_gateGuardPointPhase += m_world->deltaTime * k_reverseGuardPointChangePeriod;
 		m_gateGuardPointPhase -= static_cast<float>(static_cast<int>(m_gateGuardPointPhase));
 
-		const float gateWidth = glm::length(m_ownGateRectangle.axis1);
-		const glm::vec2 phaseOffset(cosf(m_gateGuardPointPhase * 2.0f * M_PI) * gateWidth * 0.25f, 0.0f);
-		const glm::vec2 referencePoint = m_ownGateRectangle.Nearest(m_puck->GetPosition()) + phaseOffset;
-		const glm::vec2 aimPoint = referencePoint + glm::normalize(m_puck->GetPosition() - referencePoint) * k_defendDistance;
+		const glm::vec2 aimPoint = GetGuardPoint();
 
 		if (glm::distance(m_controlTarget->GetPosition(), aimPoint) > k_enoughDestinationDistance)
 		{
@@ -155,14 +188,66 @@ void AIController::Update()
 		}
 	}
 
+	m_moveDirection = moveDirection;
 	m_controlTarget->AccelerateWithLimit(moveDirection * m_moveForce, k_maxSpeed);
 }
 
+
+unsigned int AIController::GetIdleTicks() const
+{
+	if (m_moveDirection.x != 0.0f || m_moveDirection.y != 0.0f) { return 0; }
+
+	const glm::vec2 puckPosition = m_puck->GetPosition();
+	const float puckSpeed = glm::length(m_puck->GetVelocity());
+
+	//chasing may start once waiting is over and the puck has reached own area
+	float idleTime = INFINITY;
+
+	if (m_puck->IsEnabled())
+	{
+		const float puckDistance = glm::distance(m_ownArea.Nearest(puckPosition), puckPosition);
+
+		idleTime = glm::max(m_remainingWaiting, (puckSpeed > 0.0f) ? puckDistance / puckSpeed : INFINITY);
+	}
+
+	//guarding stick moves again when the guard point drifts away farther than enough distance
+	const float gateWidth = m_ownGateRectangle.halfSize.x;
+	const float phaseOffsetSpeed = 2.0f * static_cast<float>(M_PI) * k_reverseGuardPointChangePeriod * gateWidth * 0.25f;
+	const float referenceSpeed = puckSpeed + phaseOffsetSpeed;
+
+	const glm::vec2 phaseOffset(cosf(m_gateGuardPointPhase * 2.0f * M_PI) * gateWidth * 0.25f, 0.0f);
+	const float referenceDistance = glm::distance(m_ownGateRectangle.Nearest(puckPosition) + phaseOffset, puckPosition);
+
+	//defend direction turns slower than that while the puck stays at least half of its distance away
+	idleTime = glm::min(idleTime, 0.5f * referenceDistance / (puckSpeed + referenceSpeed));
+
+	const float guardPointSpeed = referenceSpeed + k_defendDistance * (puckSpeed + referenceSpeed) / (0.5f * referenceDistance);
+	const float stickSpeed = glm::length(m_controlTarget->GetVelocity());
+	const float slack = k_enoughDestinationDistance - glm::distance(m_controlTarget->GetPosition(), GetGuardPoint());
+
+	idleTime = glm::min(idleTime, slack / (guardPointSpeed + stickSpeed));
+
+	//last tick is left out, phase of the guard point advances before the decision
+	const float idleTicks = floorf(idleTime / m_world->deltaTime) - 1.0f;
+
+	return (idleTicks > 0.0f) ? static_cast<unsigned int>(glm::min(idleTicks, 1e6f)) : 0;
+}
+
+
+void AIController::SkipIdleTicks(unsigned int ticks)
+{
+	const float duration = m_world->deltaTime * static_cast<float>(ticks);
+
+	m_remainingWaiting = fmaxf(m_remainingWaiting - duration, 0.0f);
+
+	m_gateGuardPointPhase += duration * k_reverseGuardPointChangePeriod;
+	m_gateGuardPointPhase -= static_cast<float>(static_cast<int>(m_gateGuardPointPhase));
+}
+
+
 void AIController::OnNextRound()
 {
-	srand(std::chrono::steady_clock::now().time_since_epoch().count());
-	
-	const float randomValue = 0.0001f * static_cast<float>(rand() % 10000);
+	const float randomValue = 0.0001f * static_cast<float>(m_world->Random() % 10000);
 	const float randomTime = (k_maxAiNextRoundWaitDuration - k_minAiNextRoundWaitDuration) * randomValue;
 
 	m_remainingWaiting = k_minAiNextRoundWaitDuration + randomTime;
@@ -171,4 +256,13 @@ void AIController::OnNextRound()
 void AIController::OnPuckCollision()
 {
 	m_remainingWaiting = 0.0f;
+}
+
+glm::vec2 AIController::GetGuardPoint() const
+{
+	const float gateWidth = m_ownGateRectangle.halfSize.x;
+	const glm::vec2 phaseOffset(cosf(m_gateGuardPointPhase * 2.0f * M_PI) * gateWidth * 0.25f, 0.0f);
+	const glm::vec2 referencePoint = m_ownGateRectangle.Nearest(m_puck->GetPosition()) + phaseOffset;
+
+	return referencePoint + glm::normalize(m_puck->GetPosition() - referencePoint) * k_defendDistance;
 }
\ No newline at end of file
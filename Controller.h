@@ -8,13 +8,16 @@
 
 
 class Entity;
+class GameWorld;
 
 
 class Controller
 {
 public:
-	Controller() :
+	explicit Controller(GameWorld& world) :
+		m_world(&world),
 		m_controlTarget(nullptr),
+		m_moveDirection(0.0f, 0.0f),
 		m_moveForce(1.0f)
 	{}
 
@@ -22,17 +25,24 @@ public:
 
 	virtual void Update() = 0;
 
+	//ticks ahead during which the controller surely applies no force, if bodies don't collide meanwhile
+	virtual unsigned int GetIdleTicks() const { return 0; }
+	virtual void SkipIdleTicks(unsigned int) {} //instead of that many updates
+
 	void SetControlTarget(Entity *entity)
 	{
 		m_controlTarget = entity;
 	}
 
+	inline const glm::vec2& GetMoveDirection() const { return m_moveDirection; } //decision of the last update
 	inline void SetMoveForce(float force) { m_moveForce = force; }
 	inline void SetArea(const rectangle& area) { m_ownArea = area; }
 
 protected:
+	GameWorld *m_world;
 	Entity *m_controlTarget;
 
+	glm::vec2 m_moveDirection;
 	float m_moveForce;
 
 	rectangle m_ownArea;
@@ -42,16 +52,20 @@ protected:
 class KeyboardController final : public Controller
 {
 public:
-	KeyboardController();
+	explicit KeyboardController(GameWorld& world);
 
 	void Update() override;
 
+	unsigned int GetIdleTicks() const override; //keys change between ticks only, never within a leap
+
 	void OnKeyboardDown(SDL_Scancode sdlScancode);
 	void OnKeyboardUp(SDL_Scancode sdlScancode);
 
+	Uint8 GetKeyState() const; //pressed direction keys as down, left, right, up bits
+	void SetKeyState(Uint8 state);
+
 private:
 	SDL_Scancode m_down, m_left, m_right, m_up;
-	glm::vec2 m_moveDirection;
 	bool m_moveDown, m_moveLeft, m_moveRight, m_moveUp;
 
 	glm::vec2 GetDirection() const;
@@ -61,10 +75,14 @@ private:
 class AIController final : public Controller
 {
 public:
-	AIController();
+	explicit AIController(GameWorld& world);
+	~AIController() override;
 
 	void Update() override;
 
+	unsigned int GetIdleTicks() const override;
+	void SkipIdleTicks(unsigned int ticks) override;
+
 	inline void SetPuck(Entity *puck) { m_puck = puck; }
 	inline void SetOwnGateRectangle(const rectangle& gate) { m_ownGateRectangle = gate; }
 	inline void SetOpponentGateRectangle(const rectangle& gate) { m_opponentGateRectangle = gate; }
@@ -72,11 +90,15 @@ public:
 private:
 	void OnNextRound();
 	void OnPuckCollision();
-	
+
+	glm::vec2 GetGuardPoint() const; //stick waits there while it doesn't chase the puck
+
 private:
 	Entity *m_puck;
 	rectangle m_ownGateRectangle;
 	rectangle m_opponentGateRectangle;
 	float m_remainingWaiting;
 	float m_gateGuardPointPhase;
+
+	EventHandle m_nextRoundListener, m_puckCollisionListener; //on world events, removed with the controller
 };
\ No newline at end of file
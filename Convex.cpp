@@ -0,0 +1,101 @@
+#include "Convex.h"
+
+#include <SDL.h>
+
+
+hull::hull() :
+	count(1),
+	radius(0.0f)
+{
+	vertices[0] = glm::vec2(0.0f, 0.0f);
+}
+
+
+hull::hull(const glm::vec2* vertices, int count, float radius) :
+	count(count),
+	radius(radius)
+{
+	SDL_assert(count > 0 && count <= k_maxVertices);
+
+	for (int i = 0; i < count; i++)
+	{
+		this->vertices[i] = vertices[i];
+	}
+}
+
+
+hull hull::Capsule(const glm::vec2& halfAxis, float radius)
+{
+	const glm::vec2 ends[] = { -halfAxis, halfAxis };
+
+	return hull(ends, 2, radius);
+}
+
+
+hull hull::Box(const glm::vec2& halfSize, float radius)
+{
+	const glm::vec2 corners[] =
+	{
+		glm::vec2(-halfSize.x, -halfSize.y),
+		glm::vec2(halfSize.x, -halfSize.y),
+		glm::vec2(halfSize.x, halfSize.y),
+		glm::vec2(-halfSize.x, halfSize.y),
+	};
+
+	return hull(corners, 4, radius);
+}
+
+
+void hull::Bounds(glm::vec2& min, glm::vec2& max) const
+{
+	min = max = vertices[0];
+
+	for (int i = 1; i < count; i++)
+	{
+		min = glm::min(min, vertices[i]);
+		max = glm::max(max, vertices[i]);
+	}
+
+	min -= radius;
+	max += radius;
+}
+
+
+convex::convex() :
+	position(0.0f, 0.0f),
+	outline(nullptr)
+{}
+
+
+convex::convex(const glm::vec2& position, const hull& outline) :
+	position(position),
+	outline(&outline)
+{}
+
+
+int convex::Support(const glm::vec2& direction) const
+{
+	int best = 0;
+	float bestDistance = glm::dot(outline->vertices[0], direction);
+
+	for (int i = 1; i < outline->count; i++)
+	{
+		const float distance = glm::dot(outline->vertices[i], direction);
+		if (distance > bestDistance)
+		{
+			best = i;
+			bestDistance = distance;
+		}
+	}
+
+	return best;
+}
+
+
+void convex::Bounds(glm::vec2& min, glm::vec2& max) const
+{
+	outline->Bounds(min, max);
+
+	min += position;
+	max += position;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Manifold.h"
+
+
+// convex hull of up to k_maxVertices points inflated by a radius; capsules are
+// two points with a radius, rounded boxes four. Only the support mapping is
+// needed, every pair with it goes through the general convex queries. Vertices
+// are kept out of line in a hull, a convex only places one, so shapes stay small
+
+
+struct hull final
+{
+	static const int k_maxVertices = 8;
+
+	glm::vec2 vertices[k_maxVertices]; //relative to the position of the convex placing it
+	int count;
+	float radius; //rounding of the whole hull
+
+	hull();
+	hull(const glm::vec2* vertices, int count, float radius = 0.0f);
+
+	static hull Capsule(const glm::vec2& halfAxis, float radius); //ends at plus and minus the half axis
+	static hull Box(const glm::vec2& halfSize, float radius = 0.0f); //rounded if radius is given
+
+	void Bounds(glm::vec2& min, glm::vec2& max) const; //axis aligned around its origin, with the radius
+};
+
+
+struct convex final
+{
+	glm::vec2 position;
+	const hull* outline; //owned elsewhere, has to outlive the convex
+
+	convex();
+	convex(const glm::vec2& position, const hull& outline);
+
+	int Support(const glm::vec2& direction) const;
+	inline glm::vec2 Vertex(int index) const { return position + outline->vertices[index]; }
+	inline float Margin() const { return outline->radius; }
+
+	void Bounds(glm::vec2& min, glm::vec2& max) const; //axis aligned, with the radius
+};
\ No newline at end of file
@@ -1,12 +1,8 @@
 #include "Entity.h"
 
+#include "AllocationTracker.h"
 #include "Game.h"
-
-
-namespace
-{
-	const float kPenetrationRepellingCoefficient = 1.5f;
-}
+#include "GameWorld.h"
 
 
 shape::shape() :
@@ -14,27 +10,37 @@ shape::shape() :
 {}
 
 
-float shape::Contact(const shape& other) const
+const shape::ContactFunction shape::k_contactFunctions[TYPE_COUNT][TYPE_COUNT] =
 {
-	switch (shape::Combination(m_type, other.m_type))
-	{
-		case shape::Combination(shape::LINE, shape::LINE): return m_data.m_line.Contact(other.m_data.m_line);
-		case shape::Combination(shape::LINE, shape::CIRCLE): return m_data.m_line.Contact(other.m_data.m_circle);
-		case shape::Combination(shape::LINE, shape::RECTANGLE): return m_data.m_line.Contact(other.m_data.m_rectangle);
-		case shape::Combination(shape::CIRCLE, shape::LINE): return m_data.m_circle.Contact(other.m_data.m_line);
-		case shape::Combination(shape::CIRCLE, shape::CIRCLE): return m_data.m_circle.Contact(other.m_data.m_circle);
-		case shape::Combination(shape::CIRCLE, shape::RECTANGLE): return m_data.m_circle.Contact(other.m_data.m_rectangle);
-		case shape::Combination(shape::RECTANGLE, shape::LINE): return m_data.m_rectangle.Contact(other.m_data.m_line);
-		case shape::Combination(shape::RECTANGLE, shape::CIRCLE): return m_data.m_rectangle.Contact(other.m_data.m_circle);
-		case shape::Combination(shape::RECTANGLE, shape::RECTANGLE): return m_data.m_rectangle.Contact(other.m_data.m_rectangle);
-
-		default:
-		{
-			SDL_assert(false);
-			std::cerr << "Unhandled combination of geomentry shapes\n";
-			return 0.0f;
-		}
-	}
+	{ &ContactShapes<line, line>, &ContactShapes<line, circle>, &ContactShapes<line, rectangle>, &ContactShapes<line, convex> },
+	{ &ContactShapes<circle, line>, &ContactShapes<circle, circle>, &ContactShapes<circle, rectangle>, &ContactShapes<circle, convex> },
+	{ &ContactShapes<rectangle, line>, &ContactShapes<rectangle, circle>, &ContactShapes<rectangle, rectangle>, &ContactShapes<rectangle, convex> },
+	{ &ContactShapes<convex, line>, &ContactShapes<convex, circle>, &ContactShapes<convex, rectangle>, &ContactShapes<convex, convex> },
+};
+
+
+const shape::SweepFunction shape::k_sweepFunctions[TYPE_COUNT][TYPE_COUNT] =
+{
+	{ &SweepShapes<line, line>, &SweepShapes<line, circle>, &SweepShapes<line, rectangle>, &SweepShapes<line, convex> },
+	{ &SweepShapes<circle, line>, &SweepShapes<circle, circle>, &SweepShapes<circle, rectangle>, &SweepShapes<circle, convex> },
+	{ &SweepShapes<rectangle, line>, &SweepShapes<rectangle, circle>, &SweepShapes<rectangle, rectangle>, &SweepShapes<rectangle, convex> },
+	{ &SweepShapes<convex, line>, &SweepShapes<convex, circle>, &SweepShapes<convex, rectangle>, &SweepShapes<convex, convex> },
+};
+
+
+manifold shape::Contact(const shape& other) const
+{
+	SDL_assert(m_type < TYPE_COUNT && other.m_type < TYPE_COUNT);
+
+	return k_contactFunctions[m_type][other.m_type](*this, other);
+}
+
+
+manifold shape::Sweep(const glm::vec2& displacement, const shape& other) const
+{
+	SDL_assert(m_type < TYPE_COUNT && other.m_type < TYPE_COUNT);
+
+	return k_sweepFunctions[m_type][other.m_type](*this, displacement, other);
 }
 
 
@@ -51,145 +57,163 @@ void shape::Translate(const glm::vec2& distance)
 
 		case Type::CIRCLE: m_data.m_circle.position += distance; return;
 		case Type::RECTANGLE: m_data.m_rectangle.position += distance; return;
+		case Type::CONVEX: m_data.m_convex.position += distance; return;
+		case Type::TYPE_COUNT: SDL_assert(false); return;
+	}
+}
+
+
+void shape::Bounds(glm::vec2& min, glm::vec2& max) const
+{
+	switch (m_type)
+	{
+		case Type::LINE:
+		{
+			min = glm::min(m_data.m_line.point1, m_data.m_line.point2);
+			max = glm::max(m_data.m_line.point1, m_data.m_line.point2);
+			return;
+		}
+
+		case Type::CIRCLE:
+		{
+			min = m_data.m_circle.position - m_data.m_circle.radius;
+			max = m_data.m_circle.position + m_data.m_circle.radius;
+			return;
+		}
+
+		case Type::RECTANGLE:
+		{
+			const glm::vec2 extent = glm::abs(m_data.m_rectangle.Axis1()) + glm::abs(m_data.m_rectangle.Axis2());
+			min = m_data.m_rectangle.position - extent;
+			max = m_data.m_rectangle.position + extent;
+			return;
+		}
+
+		case Type::CONVEX: m_data.m_convex.Bounds(min, max); return;
+		case Type::TYPE_COUNT: SDL_assert(false); return;
 	}
 }
 
 
-Entity::Entity() :
-	m_isEnabled(true),
-	m_isStatic(false),
-	m_isPhysical(true),
-	m_position(0.0f, 0.0f),
+Entity::Entity(GameWorld& world, BodyStore::handle_t body) :
+	m_world(&world),
+	m_bodies(&world.GetBodies()),
+	m_body(body),
 	m_size(1.0f, 1.0f),
-	m_mass(0.0f),
-	m_velocity(0.0f, 0.0f),
 	m_sdlRenderer(nullptr)
 {
-	UpdateRect();
+	UpdateRect(GetPosition());
 }
 
 
-float Entity::Contact(const Entity &other) const
+manifold Entity::Contact(const Entity &other) const
 {
-	if (!(m_layerMask & other.m_collisionMask)) { return false; }
+	return m_bodies->Contact(m_body, other.m_body, GetDeltaTime());
+}
 
-	const float k_timeStep = 0.05f;
 
-	if (IsMoving() || other.IsMoving())
-	{
-		shape tempShape1 = m_shape;
-		shape tempShape2 = other.m_shape;
+manifold Entity::Sweep(const Entity &other) const
+{
+	return GetShape().Sweep((GetVelocity() - other.GetVelocity()) * GetDeltaTime(), other.GetShape());
+}
 
-		for (float i = 0.0f; i < 1.0f; i += k_timeStep)
-		{
-			const float penetration = tempShape1.Contact(tempShape2);
-			if (penetration > 0.0f) { return penetration; }
 
-			tempShape1.Translate(m_velocity * Game::deltaTime * k_timeStep);
-			tempShape2.Translate(other.m_velocity * Game::deltaTime * k_timeStep);
-		}
-	}
-	else
-	{
-		return m_shape.Contact(other.m_shape);
-	}
+void Entity::Collide(Entity &other, const manifold& contact)
+{
+	m_bodies->Resolve(m_body, other.m_body, contact);
+}
 
-	return 0.0f;
+
+void Entity::ReflectFrom(const manifold& contact, float consumedVelocityRatio)
+{
+	m_bodies->Reflect(m_body, contact, consumedVelocityRatio);
 }
 
 
-void Entity::Collide(Entity &other, float penetration)
+void Entity::BeginCollision(Entity &other)
 {
 	m_onCollision.Invoke(this, &other);
 	other.m_onCollision.Invoke(&other, this);
 
-	m_onCollisionWithLayer.Invoke(this, other.m_layerMask);
-	other.m_onCollisionWithLayer.Invoke(&other, m_layerMask);
-
-	if (!m_isPhysical || !other.m_isPhysical) { return; }
+	m_onCollisionWithLayer.Invoke(this, other.GetLayerMask());
+	other.m_onCollisionWithLayer.Invoke(&other, GetLayerMask());
+}
 
-	if (!m_isStatic && !other.m_isStatic)
-	{
-		const glm::vec2 normal = glm::normalize(other.m_position - m_position);
-		const glm::vec2 tangent = glm::vec2(normal.y, -normal.x); //rotate 90 degrees
 
-		const float normalSpeed1 = glm::dot(m_velocity, normal);
-		const float tangentSpeed1 = glm::dot(m_velocity, tangent);
+void Entity::BeginCollision(mask_t layerMask)
+{
+	m_onCollisionWithLayer.Invoke(this, layerMask);
+}
 
-		const float normalSpeed2 = glm::dot(other.m_velocity, normal);
-		const float tangentSpeed2 = glm::dot(other.m_velocity, tangent);
 
-		const float reverseMassSum = 1.0f / (m_mass + other.m_mass);
+void Entity::PersistCollision(Entity &other)
+{
+	m_onCollisionPersist.Invoke(this, &other);
+	other.m_onCollisionPersist.Invoke(&other, this);
 
-		const float newNormalSpeed1 = ((m_mass - other.m_mass) * normalSpeed1 + 2.0f * other.m_mass * normalSpeed2) * reverseMassSum;
-		const float newNormalSpeed2 = ((other.m_mass - m_mass) * normalSpeed2 + 2.0f * m_mass * normalSpeed1) * reverseMassSum;
+	m_onCollisionPersistWithLayer.Invoke(this, other.GetLayerMask());
+	other.m_onCollisionPersistWithLayer.Invoke(&other, GetLayerMask());
+}
 
-		const float repellingSpeed = -penetration * kPenetrationRepellingCoefficient * 0.5f;
 
-		m_velocity = (newNormalSpeed1 + repellingSpeed) * normal + tangentSpeed1 * tangent;
-		other.m_velocity = (newNormalSpeed2 - repellingSpeed) * normal + tangentSpeed2 * tangent;
-	}
-	else
-	{
-		if (m_isStatic && other.m_isStatic) { return; }
+void Entity::PersistCollision(mask_t layerMask)
+{
+	m_onCollisionPersistWithLayer.Invoke(this, layerMask);
+}
 
-		if (m_isStatic && !other.m_isStatic)
-		{
-			const glm::vec2 normal = glm::normalize(other.m_position - m_position);
-			const glm::vec2 tangent = glm::vec2(normal.y, -normal.x); //rotate 90 degrees
 
-			const float normalSpeed2 = glm::dot(other.m_velocity, normal);
-			const float tangentSpeed2 = glm::dot(other.m_velocity, tangent);
+void Entity::EndCollision(Entity &other)
+{
+	m_onCollisionEnd.Invoke(this, &other);
+	other.m_onCollisionEnd.Invoke(&other, this);
 
-			other.m_velocity = -normalSpeed2 * normal + tangentSpeed2 * tangent;
-		}
-		else
-		{
-			const glm::vec2 normal = glm::normalize(other.m_position - m_position);
-			const glm::vec2 tangent = glm::vec2(normal.y, -normal.x); //rotate 90 degrees
+	m_onCollisionEndWithLayer.Invoke(this, other.GetLayerMask());
+	other.m_onCollisionEndWithLayer.Invoke(&other, GetLayerMask());
+}
 
-			const float normalSpeed1 = glm::dot(m_velocity, normal);
-			const float tangentSpeed1 = glm::dot(m_velocity, tangent);
 
-			m_velocity = -normalSpeed1 * normal + tangentSpeed1 * tangent;
-		}
-	}
+void Entity::EndCollision(mask_t layerMask)
+{
+	m_onCollisionEndWithLayer.Invoke(this, layerMask);
 }
 
 
-void Entity::ReflectFrom(const line& other, mask_t layerMask, float consumedVelocityRatio)
+void Entity::Animate(float deltaTime)
 {
-	SDL_assert(consumedVelocityRatio >= 0.0f && consumedVelocityRatio <= 1.0f);
-
-	m_onCollisionWithLayer.Invoke(this, layerMask);
+	m_animationController.Update(deltaTime);
+}
 
-	const glm::vec2 nearestPoint = other.Nearest(m_position);
 
-	const glm::vec2 normal = glm::normalize(nearestPoint - m_position);
-	const glm::vec2 tangent(normal.y, -normal.x); //rotate 90 degrees
+void Entity::Play(const std::string& animation)
+{
+	m_animationController.Play(animation);
+	m_world->StartAnimating(m_body);
+}
 
-	const float normalSpeed = glm::dot(m_velocity, normal) * (1.0f - consumedVelocityRatio);
-	const float tangentSpeed = glm::dot(m_velocity, tangent);
 
-	m_velocity = -normalSpeed * normal + tangentSpeed * tangent;	
+void Entity::PlayIfNotPlaying(const std::string& animation)
+{
+	m_animationController.PlayIfNotPlaying(animation);
+	m_world->StartAnimating(m_body);
 }
 
 
-void Entity::Update()
+void Entity::Resume()
 {
-	m_animationController.Update();
+	m_animationController.Resume();
+	m_world->StartAnimating(m_body);
+}
 
-	if (IsMoving())
-	{
-		m_position += m_velocity * Game::deltaTime;
-		UpdateRect();
-		UpdateShape();
 
-		if (m_friction > 0) { ApplyFriction(); }
-	}
+Animation* Entity::AddAnimation(const std::string& name, Animation *animation)
+{
+	AllocationScope allocationScope(AllocationTracker::ANIMATIONS);
+
+	m_world->StartAnimating(m_body); //first update picks the initial animation
+	return m_animationController.AddAnimation(name, animation);
 }
 
-void Entity::Draw()
+void Entity::Draw(float interpolation)
 {
 	if (!m_sdlRenderer) { return; }
 
@@ -197,99 +221,92 @@ void Entity::Draw()
 
 	const Animation::Frame& frame = m_animationController.GetCurrentFrame();
 
+	UpdateRect(glm::mix(m_bodies->previousPositions[m_body], GetPosition(), interpolation));
+
 	SDL_RenderCopy(m_sdlRenderer, frame.texture, &frame.rect, &m_sdlRect);
 }
 
 
 void Entity::AccelerateWithLimit(const glm::vec2& acceleration, float maxSpeed)
 {
-	if (glm::length(m_velocity) < maxSpeed)
+	glm::vec2& velocity = m_bodies->velocities[m_body];
+
+	if (glm::length(velocity) < maxSpeed)
 	{
-		m_velocity += acceleration * Game::deltaTime;
+		velocity += acceleration * m_world->deltaTime;
 	}
+
+	if (acceleration.x != 0.0f || acceleration.y != 0.0f) { m_bodies->Wake(m_body); }
 }
 
 
 void Entity::SetPosition(const glm::vec2& position)
 {
-	m_position = position;
-	UpdateRect();
-	UpdateShape();
+	m_bodies->SetPosition(m_body, position);
 }
 
 
 void Entity::SetAnchoredPosition(const glm::vec2& position, const glm::vec2& anchor)
 {
-	m_position.x = anchor.x + position.x;
-	m_position.y = anchor.y * Game::reverseWindowRatio + position.y;
-	UpdateRect();
-	UpdateShape();
+	m_bodies->SetPosition(m_body, glm::vec2(anchor.x + position.x, anchor.y * m_world->reverseWindowRatio + position.y));
 }
 
 
 void Entity::SetDoubleAnchoredPosition(const glm::vec2 &anchor1, const glm::vec2 &anchor2)
 {
-	m_position.x = 0.5f * (anchor1.x + anchor2.x);
-	m_position.y = 0.5f * (anchor1.y + anchor2.y) * Game::reverseWindowRatio;
-	SetSize(glm::abs(anchor1 - anchor2) * glm::vec2(1.0f, Game::reverseWindowRatio));
-	UpdateRect();
-	UpdateShape();
+	m_bodies->SetPosition(m_body, glm::vec2(0.5f * (anchor1.x + anchor2.x), 0.5f * (anchor1.y + anchor2.y) * m_world->reverseWindowRatio));
+	SetSize(glm::abs(anchor1 - anchor2) * glm::vec2(1.0f, m_world->reverseWindowRatio));
 }
 
 
 void Entity::SetSize(const glm::vec2& size)
 {
 	m_size = size;
-	UpdateRect();
 	UpdateShape();
 }
 
 
 void Entity::SetShape(shape::Type type)
 {
-	m_shape.m_type = type;
+	m_bodies->shapeTypes[m_body] = type;
 	UpdateShape();
 }
 
 
-void Entity::UpdateRect()
+void Entity::SetShape(const hull& outline)
 {
-	const float x = Game::windowSize.x * m_position.x;
-	const float y = Game::windowSize.x * m_position.y;
-	m_sdlRect.x = static_cast<int>(x) - m_sdlRect.w / 2;
-	m_sdlRect.y = Game::windowSize.y - static_cast<int>(y) - m_sdlRect.h / 2;
-	m_sdlRect.w = m_size.x * Game::windowSize.x;
-	m_sdlRect.h = m_size.y * Game::windowSize.x;
+	m_bodies->SetHull(m_body, outline);
 }
 
 
-void Entity::UpdateShape()
+float Entity::GetDeltaTime() const
 {
-	switch (m_shape.m_type)
-	{
-		case shape::CIRCLE:
-		{
-			m_shape.m_data.m_circle.position = m_position;
-			m_shape.m_data.m_circle.radius = glm::max(m_size.x, m_size.y) * 0.5f;
-		}
-
-		case shape::RECTANGLE:
-		{
-			m_shape.m_data.m_rectangle.position = m_position;
-			m_shape.m_data.m_rectangle.axis1 = glm::vec2(m_size.x * 0.5f, 0.0f);
-			m_shape.m_data.m_rectangle.axis2 = glm::vec2(0.0f, m_size.y * 0.5f);
-		}
-	}
+	return m_world->deltaTime;
 }
 
 
-void Entity::ApplyFriction()
+void Entity::UpdateRect(const glm::vec2& position)
 {
-	float speed = glm::length(m_velocity);
+	const float x = Game::windowSize.x * position.x;
+	const float y = Game::windowSize.x * position.y;
+	m_sdlRect.w = m_size.x * Game::windowSize.x;
+	m_sdlRect.h = m_size.y * Game::windowSize.x;
+	m_sdlRect.x = static_cast<int>(x) - m_sdlRect.w / 2;
+	m_sdlRect.y = Game::windowSize.y - static_cast<int>(y) - m_sdlRect.h / 2;
+}
 
-	speed -= m_friction * Game::deltaTime;
 
-	if (speed < 0) { speed = 0; }
+void Entity::UpdateShape()
+{
+	//shapes follow the body position on their own, only the size is kept
+	switch (m_bodies->shapeTypes[m_body])
+	{
+		case shape::CIRCLE: m_bodies->radii[m_body] = glm::max(m_size.x, m_size.y) * 0.5f; break;
+		case shape::RECTANGLE: m_bodies->halfSizes[m_body] = m_size * 0.5f; break;
 
-	m_velocity = glm::normalize(m_velocity) * speed;
+		case shape::CONVEX: //vertices are given with the hull
+		case shape::LINE: //borders only, placed by their points
+		case shape::TYPE_COUNT:
+			break;
+	}
 }
\ No newline at end of file
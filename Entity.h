@@ -5,13 +5,20 @@
 #include <SDL.h>
 
 #include <glm/glm.hpp>
-#include <glm/gtc/quaternion.hpp>
 
+#include "BodyStore.h"
 #include "Event.h"
 #include "Shape.h"
 #include "AnimationController.h"
 
 
+class GameWorld;
+
+
+// physics state lives in the world's BodyStore, entity keeps a handle to it
+// along with everything needed only for presentation
+
+
 class Entity
 {
 public:
@@ -21,86 +28,105 @@ public:
 	static const unsigned int PUCK_LAYER = 1 << 1;
 	static const unsigned int WALL_LAYER = 1 << 2;
 	static const unsigned int GATE_LAYER = 1 << 3;
+	static const unsigned int ARENA_PUCK_LAYER = 1 << 4;
+
+	static const size_t LAYER_COUNT = 5;
 
-	Entity();
+	Entity(GameWorld& world, BodyStore::handle_t body); //body is added to the world's store by the caller
 	virtual ~Entity() = default;
 
-	float Contact(const Entity &other) const;
+	manifold Contact(const Entity &other) const;
 
-	template<typename ShapeType> float Contact(const ShapeType &other, mask_t collisionMask = 0xFFFFFFFF) const;
+	template<typename ShapeType> manifold Contact(const ShapeType &other, mask_t collisionMask = 0xFFFFFFFF) const;
 
-	void Collide(Entity &other, float penetration);
-	void ReflectFrom(const line& other, mask_t layerMask, float consumedVelocityRatio = 0.0f);
+	//first touch within the coming step, both entities moving with their current velocities
+	manifold Sweep(const Entity &other) const;
+	template<typename ShapeType> manifold Sweep(const ShapeType &other) const;
 
-	virtual void Update();
+	//contact is seen from this entity, as returned by its Contact; these only bounce, events are raised apart
+	void Collide(Entity &other, const manifold& contact);
+	void ReflectFrom(const manifold& contact, float consumedVelocityRatio = 0.0f);
 
-	void Draw();
+	//both entities hear of it; the world raises these after every step in which contacts began, persisted or ended
+	void BeginCollision(Entity &other);
+	void BeginCollision(mask_t layerMask); //with something that is not an entity, like walls
+	void PersistCollision(Entity &other);
+	void PersistCollision(mask_t layerMask);
+	void EndCollision(Entity &other);
+	void EndCollision(mask_t layerMask);
+
+	void Animate(float deltaTime); //bodies are integrated by the world, this is presentation only
+
+	void Draw(float interpolation = 1.0f);
 
 	void AccelerateWithLimit(const glm::vec2& acceleration, float maxSpeed);
 
-	bool IsEnabled() const { return m_isEnabled; }
-	bool IsStatic() const { return m_isStatic; }
-	bool IsPhysical() const { return m_isPhysical; }
-	const glm::vec2& GetPosition() const { return m_position; }
-	const shape& GetShape() const { return m_shape; }
+	bool IsEnabled() const { return m_bodies->IsEnabled(m_body); }
+	bool IsStatic() const { return (m_bodies->flags[m_body] & BodyStore::STATIC_FLAG) != 0; }
+	bool IsPhysical() const { return (m_bodies->flags[m_body] & BodyStore::PHYSICAL_FLAG) != 0; }
+	const glm::vec2& GetPosition() const { return m_bodies->positions[m_body]; }
+	const glm::vec2& GetVelocity() const { return m_bodies->velocities[m_body]; }
+	shape GetShape() const { return m_bodies->GetShape(m_body); }
+	mask_t GetLayerMask() const { return m_bodies->layerMasks[m_body]; }
+	mask_t GetCollisionMask() const { return m_bodies->collisionMasks[m_body]; }
+	BodyStore::handle_t GetBody() const { return m_body; }
 
 	void SetPosition(const glm::vec2& position);
 	void SetAnchoredPosition(const glm::vec2& position, const glm::vec2 &anchor);
 	void SetDoubleAnchoredPosition(const glm::vec2 &anchor1, const glm::vec2 &anchor2);
 	void SetSize(const glm::vec2& size);
 	void SetShape(shape::Type type);
+	void SetShape(const hull& outline); //vertices relative to the position
 
-	inline bool IsMoving() const { return (m_velocity.x != 0) || (m_velocity.y != 0); }
-	inline bool CanCollideWith(unsigned int layerMask) { return m_collisionMask & layerMask; }
+	inline bool IsMoving() const { return m_bodies->IsMoving(m_body); }
+	inline bool CanCollideWith(unsigned int layerMask) const { return (m_bodies->collisionMasks[m_body] & layerMask) != 0; }
 
-	inline void Play(const std::string& animation) { m_animationController.Play(animation); }
-	inline void PlayIfNotPlaying(const std::string& animation) { m_animationController.PlayIfNotPlaying(animation); }
+	//these put the entity into the world's animation list, it stays there while the animation runs
+	void Play(const std::string& animation);
+	void PlayIfNotPlaying(const std::string& animation);
 	inline void Pause() { m_animationController.Pause(); }
-	inline void Resume() { m_animationController.Resume(); }
+	void Resume();
+	inline bool IsAnimating() const { return m_animationController.IsAnimating(); }
 
-	inline Animation* AddAnimation(const std::string& name, Animation *animation) { return m_animationController.AddAnimation(name, animation); }
+	Animation* AddAnimation(const std::string& name, Animation *animation);
 	inline Animation* GetAnimation(const std::string& animation) { return m_animationController.GetAnimation(animation); }
 
-	inline void SetEnabled(bool enabled) { m_isEnabled = enabled; }
+	inline void SetEnabled(bool enabled) { m_bodies->SetFlag(m_body, BodyStore::ENABLED_FLAG, enabled); }
 	inline void SetName(const std::string &name) { m_name = name; }
 	inline void SetRenderer(SDL_Renderer *renderer) { m_sdlRenderer = renderer; }
-	inline void SetVelocity(const glm::vec2& velocity) { m_velocity = velocity; }
-	inline void SetMass(float mass) { m_mass = mass; }
-	inline void SetStatic(bool isStatic) { m_isStatic = isStatic; }
-	inline void SetLayerMask(unsigned int mask) { m_layerMask = mask; }
-	inline void SetCollisionMask(unsigned int mask) { m_collisionMask = mask; }
-	inline void SetFrinction(float friction) { m_friction = friction; }
+	inline void SetVelocity(const glm::vec2& velocity) { m_bodies->velocities[m_body] = velocity; m_bodies->Wake(m_body); }
+	inline void SetMass(float mass) { m_bodies->inverseMasses[m_body] = (mass > 0.0f) ? 1.0f / mass : 0.0f; }
+	inline void SetStatic(bool isStatic) { m_bodies->SetFlag(m_body, BodyStore::STATIC_FLAG, isStatic); }
+	inline void SetLayerMask(unsigned int mask) { m_bodies->layerMasks[m_body] = mask; }
+	inline void SetCollisionMask(unsigned int mask) { m_bodies->collisionMasks[m_body] = mask; }
+	inline void SetFrinction(float friction) { m_bodies->frictions[m_body] = friction; }
 
 public:
-	Event<void(Entity*, Entity*)> m_onCollision;
-	Event<void(Entity*, mask_t layerMask)> m_onCollisionWithLayer;
+	Event<void(Entity*, Entity*)> m_onCollision; //contact began
+	Event<void(Entity*, Entity*)> m_onCollisionPersist; //still touching after the step
+	Event<void(Entity*, Entity*)> m_onCollisionEnd;
+	Event<void(Entity*, mask_t layerMask)> m_onCollisionWithLayer; //contact began
+	Event<void(Entity*, mask_t layerMask)> m_onCollisionPersistWithLayer;
+	Event<void(Entity*, mask_t layerMask)> m_onCollisionEndWithLayer;
 
 private:
-	bool m_isEnabled;
-	bool m_isStatic;
-	bool m_isPhysical;
+	GameWorld *m_world;
+	BodyStore *m_bodies;
+	BodyStore::handle_t m_body;
 
 	std::string m_name;
 
-	glm::vec2 m_position;
-	glm::quat m_orientation;
 	glm::vec2 m_size;
 
-	shape m_shape;
-	float m_mass;
-	glm::vec2 m_velocity;
-	float m_friction;
-	mask_t m_layerMask; //to which layers that object belongs
-	mask_t m_collisionMask; //with which layers this object can collide
-
 	SDL_Renderer *m_sdlRenderer;
 	SDL_Rect m_sdlRect;
 
 	AnimationController m_animationController;
 
-	void UpdateRect();
+	float GetDeltaTime() const;
+
+	void UpdateRect(const glm::vec2& position);
 	void UpdateShape();
-	void ApplyFriction();
 };
 
 
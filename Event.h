@@ -1,35 +1,138 @@
 #pragma once
 
-#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <SDL.h>
 
-template<typename function_type>
-class Event
+#include "AllocationTracker.h"
+
+
+// listeners are small callables stored inline: lambdas capturing a pointer or two
+// and free functions, so neither subscribing nor invoking allocates per listener.
+// Handles remove listeners in constant time, slots of removed ones are reused
+
+
+struct EventHandle
+{
+	Uint32 index;
+	Uint32 generation; //of the slot when the listener was added
+};
+
+
+template<typename function_type> class Delegate;
+
+template<typename... Args>
+class Delegate<void(Args...)>
 {
 public:
-	void AddListener(std::function<function_type> listener)
+	static const size_t k_capacity = 2 * sizeof(void*);
+
+	Delegate() : m_call(nullptr) {}
+
+	template<typename Callable>
+	Delegate(Callable callable) :
+		m_call(&Call<Callable>)
 	{
-		m_listeners.push_back(listener);
+		static_assert(sizeof(Callable) <= k_capacity, "Listener captures too much, capture a pointer instead");
+		static_assert(std::is_trivially_copyable<Callable>::value && std::is_trivially_destructible<Callable>::value, "Listener has to be copied bitwise");
+
+		new (&m_storage) Callable(callable);
 	}
 
-	void Invoke() const
+	template<typename... CallArgs>
+	inline void operator()(CallArgs&&... args) const { m_call(&m_storage, std::forward<CallArgs>(args)...); }
+
+	inline explicit operator bool() const { return m_call != nullptr; }
+
+private:
+	typename std::aligned_storage<k_capacity, alignof(void*)>::type m_storage;
+	void (*m_call)(const void* storage, Args... args);
+
+	template<typename Callable>
+	static void Call(const void* storage, Args... args) { (*static_cast<const Callable*>(storage))(std::forward<Args>(args)...); }
+};
+
+
+template<typename function_type> class Event;
+
+template<typename... Args>
+class Event<void(Args...)>
+{
+public:
+	using Listener = Delegate<void(Args...)>;
+
+	Event() :
+		m_firstFree(k_noSlot),
+		m_invokeDepth(0)
+	{}
+
+	//allowed while invoking, the listener is called from the next invocation on
+	EventHandle AddListener(Listener listener)
 	{
-		for (auto listener : m_listeners)
+		AllocationScope allocationScope(AllocationTracker::LISTENERS);
+
+		Uint32 index = m_firstFree;
+
+		if (index != k_noSlot && m_invokeDepth == 0) //free slots before the end may still be visited by a running invocation
+		{
+			m_firstFree = m_slots[index].nextFree;
+		}
+		else
 		{
-			listener();
+			index = static_cast<Uint32>(m_slots.size());
+			m_slots.push_back({ Listener(), 0, k_noSlot });
 		}
+
+		m_slots[index].listener = listener;
+
+		return { index, m_slots[index].generation };
 	}
 
-	template<typename... Args>
+	//handles of removed listeners are ignored, so removing twice is harmless; allowed while invoking
+	void RemoveListener(EventHandle handle)
+	{
+		if (handle.index >= m_slots.size()) { return; }
+
+		Slot& slot = m_slots[handle.index];
+		if (slot.generation != handle.generation || !slot.listener) { return; }
+
+		slot.listener = Listener();
+		slot.generation++;
+		slot.nextFree = m_firstFree;
+		m_firstFree = handle.index;
+	}
+
+	//arguments are taken by value and every listener gets the same copies, so none of them sees a moved-from one
 	void Invoke(Args... args) const
 	{
-		for (auto listener : m_listeners)
+		m_invokeDepth++;
+
+		//listeners added meanwhile go past the end and may move the slots, so slots are read by index and copied
+		const size_t count = m_slots.size();
+
+		for (size_t i = 0; i < count; i++)
 		{
-			listener(args...);
+			const Listener listener = m_slots[i].listener;
+			if (listener) { listener(args...); }
 		}
+
+		m_invokeDepth--;
 	}
 
 private:
-	std::vector<std::function<function_type>> m_listeners;
+	static const Uint32 k_noSlot = 0xFFFFFFFF;
+
+	struct Slot
+	{
+		Listener listener; //empty in free slots
+		Uint32 generation; //bumped on removal, handles of earlier listeners don't match anymore
+		Uint32 nextFree;
+	};
+
+	std::vector<Slot> m_slots;
+	Uint32 m_firstFree;
+	mutable unsigned int m_invokeDepth;
 };
\ No newline at end of file
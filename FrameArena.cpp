@@ -0,0 +1,103 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+	const size_t k_growthFactor = 2; //block grows at least that much, so a slowly rising peak spills rarely
+	const unsigned char k_poison = 0xDD; //reset memory is filled with it in debug builds, stale reads stand out
+}
+
+
+FrameArena::FrameArena(size_t capacity) :
+	m_block(capacity > 0 ? new unsigned char[capacity] : nullptr),
+	m_capacity(capacity),
+	m_used(0),
+	m_spilledSize(0),
+	m_highWaterMark(0),
+	m_retiredCapacity(0)
+{}
+
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	SDL_assert(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0);
+
+	const size_t start = (m_used + alignment - 1) & ~(alignment - 1);
+
+	if (start + size <= m_capacity)
+	{
+		m_used = start + size;
+		return m_block.get() + start;
+	}
+
+	//doesn't fit this frame, the block grows to fit the whole frame on reset
+	const size_t spillSize = std::max<size_t>(size, 1);
+	m_spills.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[spillSize]), spillSize });
+	m_spilledSize += spillSize;
+
+	return m_spills.back().memory.get();
+}
+
+
+void FrameArena::Deallocate(const void* memory, size_t size)
+{
+	//container outlived a reset of its arena
+	SDL_assert(memory == nullptr || size == 0 || (Owns(memory) && Owns(static_cast<const unsigned char*>(memory) + size - 1)));
+}
+
+
+void FrameArena::Reset()
+{
+	const size_t used = GetUsed();
+	m_highWaterMark = std::max(m_highWaterMark, used);
+
+	const size_t capacity = m_spills.empty() ? m_capacity : std::max(m_capacity * k_growthFactor, used);
+	m_spills.clear();
+
+#if SDL_ASSERT_LEVEL >= 2
+	//pointers of the last frame keep pointing to poison, so they are never mistaken for allocations of this one
+	if (m_used > 0) { memset(m_block.get(), k_poison, m_used); }
+
+	m_block.swap(m_retiredBlock);
+	std::swap(m_capacity, m_retiredCapacity);
+#endif
+
+	if (m_capacity < capacity)
+	{
+		m_block.reset(new unsigned char[capacity]);
+		m_capacity = capacity;
+	}
+
+	m_used = 0;
+	m_spilledSize = 0;
+}
+
+
+void FrameArena::Reserve(size_t capacity)
+{
+	SDL_assert(GetUsed() == 0);
+
+	if (m_capacity < capacity)
+	{
+		m_block.reset(new unsigned char[capacity]);
+		m_capacity = capacity;
+	}
+}
+
+
+bool FrameArena::Owns(const void* memory) const
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(memory);
+
+	if (bytes >= m_block.get() && bytes < m_block.get() + m_used) { return true; }
+
+	for (const Spill& spill : m_spills)
+	{
+		if (bytes >= spill.memory.get() && bytes < spill.memory.get() + spill.size) { return true; }
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <SDL.h>
+
+
+// linear allocator for data living no longer than a frame: allocating bumps an
+// offset, nothing is freed until Reset drops everything at once. A frame that
+// doesn't fit spills to the heap and the block grows to fit it on the next reset,
+// so steady frames never touch the general heap
+
+
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t capacity = 0);
+	FrameArena(const FrameArena& other) = delete;
+	FrameArena& operator= (const FrameArena& other) = delete;
+
+	void* Allocate(size_t size, size_t alignment);
+	void Deallocate(const void* memory, size_t size); //returned on reset only; debug builds check it was allocated since the last one
+	void Reset(); //containers using the arena have to be emptied before
+	void Reserve(size_t capacity); //while nothing is allocated
+
+	inline size_t GetCapacity() const { return m_capacity; }
+	inline size_t GetUsed() const { return m_used + m_spilledSize; }
+	inline size_t GetHighWaterMark() const { return (GetUsed() > m_highWaterMark) ? GetUsed() : m_highWaterMark; } //most bytes a frame took
+
+private:
+	struct Spill
+	{
+		std::unique_ptr<unsigned char[]> memory;
+		size_t size;
+	};
+
+	std::unique_ptr<unsigned char[]> m_block;
+	size_t m_capacity;
+	size_t m_used;
+
+	std::vector<Spill> m_spills; //allocations that didn't fit into the block this frame
+	size_t m_spilledSize;
+
+	size_t m_highWaterMark;
+
+	//debug builds only: block of the last frame, filled with poison; frames take turns in the two blocks
+	std::unique_ptr<unsigned char[]> m_retiredBlock;
+	size_t m_retiredCapacity;
+
+	bool Owns(const void* memory) const; //allocated since the last reset
+};
+
+
+//STL allocator on a frame arena; containers have to be emptied before the arena is reset
+template<typename T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	explicit FrameAllocator(FrameArena& arena) : m_arena(&arena) {}
+	template<typename U> FrameAllocator(const FrameAllocator<U>& other) : m_arena(other.GetArena()) {}
+
+	inline T* allocate(size_t count) { return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T))); }
+	inline void deallocate(T* memory, size_t count) { m_arena->Deallocate(memory, count * sizeof(T)); }
+
+	inline FrameArena* GetArena() const { return m_arena; }
+
+	template<typename U> inline bool operator==(const FrameAllocator<U>& other) const { return m_arena == other.GetArena(); }
+	template<typename U> inline bool operator!=(const FrameAllocator<U>& other) const { return m_arena != other.GetArena(); }
+
+private:
+	FrameArena* m_arena;
+};
\ No newline at end of file
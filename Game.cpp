@@ -1,5 +1,6 @@
 #include "Game.h"
 
+#include <cmath>
 #include <iostream>
 #include <string>
 
@@ -11,48 +12,31 @@
 namespace
 {
 	const Uint32 k_initFlags = SDL_INIT_TIMER | SDL_INIT_EVENTS | SDL_INIT_VIDEO | SDL_INIT_AUDIO;
+	const Uint32 k_headlessInitFlags = SDL_INIT_TIMER;
 	const Uint32 k_windowFlags = SDL_WINDOW_BORDERLESS | SDL_WINDOW_SHOWN;
 
 	const SDL_Scancode k_exitKeyCode = SDL_Scancode::SDL_SCANCODE_ESCAPE;
 	const SDL_Scancode k_restartKeyCode = SDL_Scancode::SDL_SCANCODE_SPACE;
 	const SDL_Scancode k_autopilotKeyCode = SDL_Scancode::SDL_SCANCODE_A;
-
-	const size_t k_maxEntities = 10;
+	const SDL_Scancode k_profilerKeyCode = SDL_Scancode::SDL_SCANCODE_F1;
 
 	const int k_scoreLetterWidth = 20;
 
-	const float k_stickMovePower = 8.75f;
-	const float k_wallsVelocityConsumption = 0.25f;
-
-	const float k_wallsWidth = 0.05f;
-	const float k_gateWidth = 0.3f;
+	const int k_profilerLineHeight = 16;
+	const Uint32 k_profilerOverlayUpdatePeriod = 500; // milliseconds
 
-	const float k_stickRadius = 0.075f;
-	const float k_stickFriction = 3.15f;
-	const float k_stickMass = 5.0f;
+	const glm::ivec2 k_headlessWindowSize(600, 800); //only proportions matter, playground is measured in window widths
 
-	const float k_puckRadius = 0.025f;
-	const float k_puckFriction = 0.11f;
-	const float k_puckMass = 1.25f;
+	const int k_eventBatchSize = 64;
 
-	const float k_puckRespawnDelay = 1.0f; // seconds
+	const int k_maxPhysicsStepsPerFrame = 8; //catch-up limit; remaining lag is dropped to avoid spiral of death
 
 	const float k_gateBlinkFreauency = 2.5f; // Hertz
 
 	const SDL_Color k_textColor = { 0, 0, 0, 255 };
-
-	const unsigned int k_stickCollisionMask = Entity::PUCK_LAYER | Entity::WALL_LAYER;
-	const unsigned int k_puckCollisionMask = Entity::STICK_LAYER | Entity::WALL_LAYER | Entity::GATE_LAYER;
-	const unsigned int k_wallCollisionMask = Entity::STICK_LAYER | Entity::PUCK_LAYER;
-	const unsigned int k_gateCollisionMask = Entity::PUCK_LAYER;
 }
 
 
-Event<void()> Game::s_onNextRound;
-Event<void()> Game::s_onPuckCollision;
-
-float Game::deltaTime;
-
 SDL_DisplayMode Game::displayMode;
 
 glm::ivec2 Game::windowPosition;
@@ -61,9 +45,22 @@ glm::ivec2 Game::windowCenter;
 float Game::windowRatio;
 float Game::reverseWindowRatio;
 
+Settings Game::s_settings;
+
 bool Game::s_isEnded = false;
 Uint32 Game::s_frameStartMoment = 0;
-float s_puckRespawnDelay = 0.0f;
+
+Uint64 Game::s_lastUpdateCounter = 0;
+double Game::s_accumulatedTime = 0.0;
+float Game::s_interpolation = 1.0f;
+
+InputQueue Game::s_input;
+Replay Game::s_replay;
+
+std::unique_ptr<GameWorld> Game::s_world;
+std::unique_ptr<MatchScheduler> Game::s_matchScheduler;
+Uint64 Game::s_simulationStartCounter = 0;
+Uint64 Game::s_simulationFinishCounter = 0;
 
 SDL_Window* Game::s_window = nullptr;
 SDL_Renderer* Game::s_renderer = nullptr;
@@ -73,20 +70,6 @@ SDL_Rect Game::s_scoreRect2;
 float Game::s_desiredFPS = 60.0f; // Hertz
 Uint32 Game::s_desiredFramePeriod; // milliseconds
 
-KeyboardController Game::s_player;
-AIController Game::s_bot;
-AIController Game::s_bot2;
-
-Controller* Game::s_player1 = nullptr;
-Controller* Game::s_player2 = nullptr;
-unsigned int Game::s_count1 = 0;
-unsigned int Game::s_count2 = 0;
-std::string s_count1Str = "0";
-std::string s_count2Str = "0";
-
-std::vector<Entity> Game::s_entities;
-std::vector<line> Game::s_borders;
-
 SDL_Texture* Game::s_backgroundTexture = nullptr;
 SDL_Texture* Game::s_puckTexture = nullptr;
 SDL_Texture* Game::s_stickTexture1 = nullptr;
@@ -101,17 +84,16 @@ TTF_Font* Game::s_font = nullptr;
 SDL_Texture* Game::s_scoreTexture1 = nullptr;
 SDL_Texture* Game::s_scoreTexture2 = nullptr;
 
+bool Game::s_isProfilerOverlayVisible = false;
+Uint32 Game::s_profilerOverlayUpdateMoment = 0;
+std::vector<SDL_Texture*> Game::s_profilerOverlayTextures;
+std::vector<SDL_Rect> Game::s_profilerOverlayRects;
+
 Mix_Music* Game::s_puckCollidesWallSound = nullptr;
 Mix_Music* Game::s_puckCollidesStickSound = nullptr;
 Mix_Music* Game::s_puckEntersGateSound = nullptr;
 Mix_Music* Game::s_scoreResetSound = nullptr;
 
-Entity* Game::s_stick1 = nullptr;
-Entity* Game::s_stick2 = nullptr;
-Entity* Game::s_puck = nullptr;
-
-circle Game::s_puckSpawner;
-
 
 const std::vector<Resource<SDL_Texture*>> Game::k_textureResources =
 {
@@ -137,23 +119,70 @@ const std::vector<Resource<Mix_Music*>> Game::k_soundResources =
 const Resource<TTF_Font*> Game::k_fontResource(Game::s_font, "Assets/consolas.ttf");
 
 
-bool Game::Init()
+bool Game::Init(const Settings& settings)
 {
+	s_settings = settings;
+
+	Profiler::SetEnabled(!s_settings.isHeadless || !s_settings.profileFile.empty());
+	AllocationTracker::SetEnabled(s_settings.isTrackingAllocations);
+
 	if(!InitCore()) { return false; }
+
+	if (s_settings.isHeadless)
+	{
+		s_matchScheduler.reset(new MatchScheduler(s_settings, reverseWindowRatio));
+		return true;
+	}
+
 	if(!InitTextures()) { return false; }
 	if(!InitAudio()) { return false; }
-	if(!InitPlayground()) { return false; }
-	if(!InitWalls()) { return false; }
 	if (!InitInterface()) { return false; }
+	if(!InitWorld()) { return false; }
 
 	Restart();
 
+	if (IsRecording())
+	{
+		s_replay.Begin(*s_world);
+	}
+
+	s_lastUpdateCounter = SDL_GetPerformanceCounter();
+
 	return true;
 }
 
 
-void Game::Exit()
+bool Game::Exit()
 {
+	if (s_settings.isHeadless)
+	{
+		if (s_matchScheduler) { ReportMatches(); }
+
+		ReportProfiler();
+		const bool isPassed = ReportAllocations();
+
+		s_matchScheduler.reset();
+		SDL_Quit();
+		return isPassed;
+	}
+
+	ReportInputLatency();
+	ReportProfiler();
+	const bool isPassed = ReportAllocations();
+
+	if (IsRecording() && s_world)
+	{
+		s_replay.Save(s_settings.recordFile);
+	}
+
+	ClearProfilerOverlay();
+
+#if SDL_ASSERT_LEVEL >= 2
+	if (s_world) { std::cout << "Step arena high-water mark: " << s_world->GetStepArena().GetHighWaterMark() << " of " << s_world->GetStepArena().GetCapacity() << " bytes\n"; }
+#endif
+
+	s_world.reset();
+
 	for (auto &texture : k_textureResources)
 	{
 		if (texture == nullptr) { continue; }
@@ -173,177 +202,192 @@ void Game::Exit()
 	SDL_DestroyWindow(s_window);
 
 	SDL_Quit();
+
+	return isPassed;
+}
+
+
+void Game::RunMatches()
+{
+	s_simulationStartCounter = SDL_GetPerformanceCounter();
+
+	s_matchScheduler->Run();
+
+	s_simulationFinishCounter = SDL_GetPerformanceCounter();
+	s_isEnded = true;
 }
 
 
 void Game::StartFrame()
 {
+	ProfileScope scope(Profiler::START_FRAME);
+
 	s_frameStartMoment = SDL_GetTicks();
 }
 
 
 void Game::ProcessEvents()
 {
-	SDL_Event sdlEvent;
-	if (SDL_PollEvent(&sdlEvent))
+	ProfileScope scope(Profiler::PROCESS_EVENTS);
+
+	SDL_Event sdlEvents[k_eventBatchSize];
+	int count;
+
+	SDL_PumpEvents();
+
+	do
 	{
-		switch (sdlEvent.type)
-		{
-			case SDL_KEYDOWN:
-			{
-				OnKeyDown(sdlEvent.key.keysym.scancode);
-				break;
-			}
+		count = SDL_PeepEvents(sdlEvents, k_eventBatchSize, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
 
-			case SDL_KEYUP:
-			{
-				OnKeyUp(sdlEvent.key.keysym.scancode);
-				break;
-			}
+		for (int i = 0; i < count; i++)
+		{
+			const SDL_Event& sdlEvent = sdlEvents[i];
 
-			case SDL_QUIT:
+			switch (sdlEvent.type)
 			{
-				s_isEnded = true;
-				break;
+				case SDL_KEYDOWN:
+				case SDL_KEYUP:
+				{
+					if (sdlEvent.key.repeat) { break; }
+
+					s_input.Push({ sdlEvent.key.timestamp, sdlEvent.key.keysym.scancode, sdlEvent.type == SDL_KEYDOWN });
+					break;
+				}
+
+				case SDL_QUIT:
+				{
+					s_isEnded = true;
+					break;
+				}
 			}
 		}
 	}
+	while (count == k_eventBatchSize);
 }
 
 
 void Game::Update()
 {
-	deltaTime = 0.001f * static_cast<float>(s_desiredFramePeriod); //fixed update is used so delta time does not change each frame
+	const float deltaTime = s_world->deltaTime;
 
-	UpdatePuck();
-	UpdatePlayers();
-	UpdatePhysics();
-	UpdateEntities();
-}
+	const Uint64 counter = SDL_GetPerformanceCounter();
+	s_accumulatedTime += static_cast<double>(counter - s_lastUpdateCounter) / SDL_GetPerformanceFrequency();
+	s_lastUpdateCounter = counter;
 
+	double simulatedMoment = SDL_GetTicks() - s_accumulatedTime * 1000.0; //milliseconds, same clock as input timestamps
 
-void Game::Render()
-{
-	SDL_RenderCopy(s_renderer, s_backgroundTexture, NULL, NULL);
+	int steps = 0;
 
-	RenderEntities();
-	RenderBorders();
-	RenderScore();
+	while (s_accumulatedTime >= deltaTime && steps < k_maxPhysicsStepsPerFrame)
+	{
+		simulatedMoment += deltaTime * 1000.0;
 
-	SDL_RenderPresent(s_renderer);
-}
+		s_input.Dispatch(simulatedMoment, OnKeyDown, OnKeyUp);
 
+		if (IsRecording())
+		{
+			s_replay.Step(*s_world);
+		}
+		else
+		{
+			s_world->Step();
+		}
 
-void Game::FinishFrame()
-{
-	const Uint32 frameDuration = SDL_GetTicks() - s_frameStartMoment;
+		s_accumulatedTime -= deltaTime;
+		steps++;
+	}
 
-	if (frameDuration < Game::s_desiredFramePeriod)
+	if (s_accumulatedTime >= deltaTime)
 	{
-		SDL_Delay(Game::s_desiredFramePeriod - frameDuration);
+		s_accumulatedTime = fmod(s_accumulatedTime, deltaTime);
 	}
-}
 
+	//restarting warms up again
+	AllocationTracker::SetStrict(s_settings.isAllocationTest && s_world->GetTicks() * deltaTime >= AllocationTracker::k_warmupDuration);
 
-void Game::Restart()
-{
-	s_count1 = 0;
-	s_count2 = 0;
-
-	SDL_Surface* surface;
-
-	surface = TTF_RenderText_Blended(s_font, std::to_string(s_count1).c_str(), k_textColor);
-	s_scoreTexture1 = SDL_CreateTextureFromSurface(s_renderer, surface);
-	SDL_FreeSurface(surface);
-
-	surface = TTF_RenderText_Blended(s_font, std::to_string(s_count2).c_str(), k_textColor);
-	s_scoreTexture2 = SDL_CreateTextureFromSurface(s_renderer, surface);
-	SDL_FreeSurface(surface);
-
-	s_stick1->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.25f));
-	s_stick2->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.75f));
-
-	s_puck->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.5f));
-	s_puck->SetVelocity(glm::vec2(0.0f, 0.0f));
-	s_puck->SetEnabled(true);
+	if (steps > 0)
+	{
+		s_world->Animate(steps * deltaTime);
+	}
 
-	s_onNextRound.Invoke();
+	s_interpolation = static_cast<float>(s_accumulatedTime / deltaTime);
 }
 
 
-Entity* Game::CreateStick(SDL_Texture *texture, SDL_Texture *animationSheet)
+void Game::Render()
 {
-	Entity &entity = AddEntity();
+	SDL_RenderCopy(s_renderer, s_backgroundTexture, NULL, NULL);
 
-	entity.SetLayerMask(Entity::STICK_LAYER);
-	entity.SetCollisionMask(k_stickCollisionMask);
-	entity.SetRenderer(s_renderer);
-	entity.SetMass(k_stickMass);
-	entity.SetShape(shape::CIRCLE);
-	entity.SetSize(glm::vec2(k_stickRadius * 2.0f));
-	entity.SetFrinction(k_stickFriction);
-	entity.m_onCollision.AddListener(OnStickCollision);
+	{
+		ProfileScope scope(Profiler::RENDER_ENTITIES);
+		RenderEntities(s_interpolation);
+	}
 
-	entity.AddAnimation("Idle", FrameAnimation::CreateSingleFrame(texture));
+	{
+		ProfileScope scope(Profiler::RENDER_BORDERS);
+		RenderBorders();
+	}
 
 	{
-		const std::vector<int> animFrames ={ 0, 1, 2, 3, 3, 3, 2, 1, 0 };
-		Animation &addedAnimation = *entity.AddAnimation("Blink", FrameAnimation::CreateFromSpriteSheet2x2(animationSheet, animFrames));
-		addedAnimation.SetNextState("Idle");
-		addedAnimation.SetDuration(0.25f);
+		ProfileScope scope(Profiler::RENDER_SCORE);
+		RenderScore();
 	}
 
-	return &entity;
+	RenderProfilerOverlay();
+
+	{
+		ProfileScope scope(Profiler::RENDER_PRESENT);
+		SDL_RenderPresent(s_renderer);
+	}
 }
 
 
-Entity* Game::CreatePuck()
+void Game::FinishFrame()
 {
-	Entity &entity = AddEntity();
-
-	entity.SetName("Puck");
-	entity.SetLayerMask(Entity::PUCK_LAYER);
-	entity.SetCollisionMask(k_puckCollisionMask);
-	entity.SetRenderer(s_renderer);
-	entity.SetMass(k_puckMass);
-	entity.SetShape(shape::CIRCLE);
-	entity.SetSize(glm::vec2(k_puckRadius * 2.0f));
-	entity.SetFrinction(k_puckFriction);
-	entity.m_onCollisionWithLayer.AddListener(OnPuckCollision);
-	entity.SetEnabled(false);
-
-	entity.AddAnimation("Idle", FrameAnimation::CreateSingleFrame(s_puckTexture));
+	const Uint32 frameDuration = SDL_GetTicks() - s_frameStartMoment;
 
-	return &entity;
+	if (frameDuration < Game::s_desiredFramePeriod)
+	{
+		SDL_Delay(Game::s_desiredFramePeriod - frameDuration);
+	}
 }
 
 
-Entity* Game::CreateGate()
+void Game::Restart()
 {
-	Entity &entity = AddEntity();
-
-	entity.SetLayerMask(Entity::GATE_LAYER);
-	entity.SetCollisionMask(k_gateCollisionMask);
-	entity.SetRenderer(s_renderer);
-	entity.SetMass(0.0f);
-	entity.SetShape(shape::RECTANGLE);
-	entity.SetStatic(true);
-
-	entity.AddAnimation("Idle", FrameAnimation::CreateSingleFrame(s_gateTexture));
+	s_world->Restart();
 
+	if (IsRecording())
 	{
-		const std::vector<int> animFrames ={ 0, 1, 2, 3 };
-		Animation &addedAnimation = *entity.AddAnimation("Score", SinusoidalTransparencyAnimation::Create(s_gateScoreTexture, M_PI, k_gateBlinkFreauency));
-		addedAnimation.SetNextState("Idle");
-		addedAnimation.SetDuration(0.75f);
+		s_replay.MarkRestart();
 	}
 
-	return &entity;
+	UpdateScoreTexture(s_scoreTexture1, s_scoreRect1, s_world->GetScore1());
+	UpdateScoreTexture(s_scoreTexture2, s_scoreRect2, s_world->GetScore2());
 }
 
 
 bool Game::InitCore()
 {
+	s_desiredFramePeriod = 1000.0f / s_desiredFPS;
+
+	if (s_settings.isHeadless)
+	{
+		if (SDL_Init(k_headlessInitFlags) != 0)
+		{
+			std::cerr << "Failed to init SDL: " << SDL_GetError() << "\n";
+			return false;
+		}
+
+		windowPosition = glm::ivec2(0, 0);
+		windowSize = k_headlessWindowSize;
+		windowCenter = glm::ivec2(windowSize.x / 2, windowSize.y / 2);
+		windowRatio = static_cast<float>(windowSize.x) / static_cast<float>(windowSize.y);
+		reverseWindowRatio = 1.0f / windowRatio;
+
+		return true;
+	}
+
 	if (SDL_Init(k_initFlags) != 0)
 	{
 		std::cerr << "Failed to init SDL: " << SDL_GetError() << "\n";
@@ -382,8 +426,6 @@ bool Game::InitCore()
 		return false;
 	}
 
-	s_desiredFramePeriod = 1000.0f / s_desiredFPS;
-
 	return true;
 }
 
@@ -403,6 +445,7 @@ bool Game::InitTextures()
 		}
 
 		resource = SDL_CreateTextureFromSurface(s_renderer, tempSurface);
+		AllocationTracker::TrackTexture(*(resource.data));
 
 		SDL_FreeSurface(tempSurface);
 
@@ -445,94 +488,24 @@ bool Game::InitAudio()
 }
 
 
-bool Game::InitPlayground()
+bool Game::InitWorld()
 {
-	s_entities.reserve(k_maxEntities);
-
-	s_stick1 = CreateStick(s_stickTexture1, s_stickAnimationSheet1);
-	if (s_stick1)
-	{
-		s_stick1->SetName("Stick 1");
-	}
-
-	s_stick2 = CreateStick(s_stickTexture2, s_stickAnimationSheet2);
-	if (s_stick2)
-	{
-		s_stick2->SetName("Stick 2");
-	}
-
-	s_puck = CreatePuck();
-
-	Entity *wall;
-
-	Entity *gate1 = CreateGate();
-	gate1->m_onCollision.AddListener(OnPlayerScore);
-	gate1->m_onCollision.AddListener(OnPlayer2Score);
-	gate1->SetSize(glm::vec2(k_gateWidth, k_wallsWidth * 0.5f));
-	gate1->SetAnchoredPosition(glm::vec2(0.0f, k_wallsWidth * 0.25f), glm::vec2(0.5f, 0.0f));
-
-	Entity *gate2 = CreateGate();
-	gate2->m_onCollision.AddListener(OnPlayerScore);
-	gate2->m_onCollision.AddListener(OnPlayer1Score);
-	gate2->SetSize(glm::vec2(k_gateWidth, k_wallsWidth * 0.5f));
-	gate2->SetAnchoredPosition(glm::vec2(0.0f, -k_wallsWidth * 0.25f), glm::vec2(0.5f, 1.0f));
-
-	s_player1 = &s_player;
-	s_player2 = &s_bot;
-
-	s_player.SetControlTarget(s_stick1);
-	s_player.SetMoveForce(k_stickMovePower);
-	s_player.SetArea(rectangle(glm::vec2(0.5f, 0.25f * reverseWindowRatio), glm::vec2(1.0f, reverseWindowRatio * 0.24f)));
-
-	s_bot.SetControlTarget(s_stick2);
-	s_bot.SetMoveForce(k_stickMovePower);
-	s_bot.SetArea(rectangle(glm::vec2(0.5f, 0.75f * reverseWindowRatio), glm::vec2(1.0f, reverseWindowRatio * 0.27f)));
-
-	s_bot2.SetControlTarget(s_stick1);
-	s_bot2.SetMoveForce(k_stickMovePower);
-	s_bot2.SetArea(rectangle(glm::vec2(0.5f, 0.25f * reverseWindowRatio), glm::vec2(1.0f, reverseWindowRatio * 0.27f)));
-
-	SDL_assert(gate2->GetShape().m_type == shape::RECTANGLE);
-	s_bot.SetPuck(s_puck);
-	s_bot.SetOwnGateRectangle(gate2->GetShape().m_data.m_rectangle);
-	s_bot.SetOpponentGateRectangle(gate1->GetShape().m_data.m_rectangle);
-
-	SDL_assert(gate1->GetShape().m_type == shape::RECTANGLE);
-	s_bot2.SetPuck(s_puck);
-	s_bot2.SetOwnGateRectangle(gate1->GetShape().m_data.m_rectangle);
-	s_bot2.SetOpponentGateRectangle(gate2->GetShape().m_data.m_rectangle);
-
-	s_puckSpawner.position = glm::vec2(0.5f, reverseWindowRatio * 0.5f);
-	s_puckSpawner.radius = k_puckRadius * 2.5f;
-
-	return true;
-}
+	s_world.reset(new GameWorld(1.0f / s_settings.physicsRate, reverseWindowRatio, s_settings.seed, s_settings.arenaPuckCount, s_settings.entityCapacity));
+	s_world->SetPhysicsThreadCount(s_settings.physicsThreadCount);
 
+	DecorateStick(*s_world->GetStick1(), s_stickTexture1, s_stickAnimationSheet1);
+	DecorateStick(*s_world->GetStick2(), s_stickTexture2, s_stickAnimationSheet2);
+	DecoratePuck(*s_world->GetPuck());
+	DecorateGate(*s_world->GetGate1());
+	DecorateGate(*s_world->GetGate2());
 
-bool Game::InitWalls()
-{
-	const std::vector<glm::vec2> borderStrip =
+	for (Entity* puck : s_world->GetArenaPucks())
 	{
-		glm::vec2(k_wallsWidth, k_wallsWidth),
-		glm::vec2(k_wallsWidth, reverseWindowRatio - k_wallsWidth),
-		glm::vec2(0.5f - k_gateWidth * 0.5f, reverseWindowRatio - k_wallsWidth),
-		glm::vec2(0.5f - k_gateWidth * 0.5f, reverseWindowRatio),
-		glm::vec2(0.5f + k_gateWidth * 0.5f, reverseWindowRatio),
-		glm::vec2(0.5f + k_gateWidth * 0.5f, reverseWindowRatio - k_wallsWidth),
-		glm::vec2(1.0f - k_wallsWidth, reverseWindowRatio - k_wallsWidth),
-		glm::vec2(1.0f - k_wallsWidth, k_wallsWidth),
-		glm::vec2(0.5f + k_gateWidth * 0.5f, k_wallsWidth),
-		glm::vec2(0.5f + k_gateWidth * 0.5f, 0.0f),
-		glm::vec2(0.5f - k_gateWidth * 0.5f, 0.0f),
-		glm::vec2(0.5f - k_gateWidth * 0.5f, k_wallsWidth),
-	};
-
-	for (int i = 0; i < borderStrip.size() - 1; i++)
-	{
-		s_borders.push_back(line(borderStrip[i], borderStrip[i+1]));
+		DecoratePuck(*puck);
 	}
 
-	s_borders.push_back(line(borderStrip[borderStrip.size() - 1], borderStrip[0]));
+	s_world->m_onScore.AddListener(OnPlayerScore);
+	s_world->m_onPuckCollision.AddListener(OnPuckCollision);
 
 	return true;
 }
@@ -557,136 +530,259 @@ bool Game::InitInterface()
 	s_scoreRect2.w = k_scoreLetterWidth;
 	s_scoreRect2.h = 25;
 
+	s_profilerOverlayTextures.reserve(Profiler::PHASE_COUNT); //toggling the overlay doesn't allocate after warm-up
+	s_profilerOverlayRects.reserve(Profiler::PHASE_COUNT);
+
 	return true;
 }
 
 
-Entity& Game::AddEntity()
+void Game::DecorateStick(Entity &entity, SDL_Texture *texture, SDL_Texture *animationSheet)
 {
-	SDL_assert(s_entities.size() < k_maxEntities);
+	AllocationScope allocationScope(AllocationTracker::ANIMATIONS);
 
-	s_entities.emplace_back();
+	entity.SetRenderer(s_renderer);
+
+	entity.AddAnimation("Idle", FrameAnimation::CreateSingleFrame(texture));
 
-	return s_entities.back();
+	{
+		const std::vector<int> animFrames ={ 0, 1, 2, 3, 3, 3, 2, 1, 0 };
+		Animation &addedAnimation = *entity.AddAnimation("Blink", FrameAnimation::CreateFromSpriteSheet2x2(animationSheet, animFrames));
+		addedAnimation.SetNextState("Idle");
+		addedAnimation.SetDuration(0.25f);
+	}
 }
 
 
-void Game::UpdatePuck()
+void Game::DecoratePuck(Entity &entity)
 {
-	if (!s_puck->IsEnabled())
-	{
-		s_puckRespawnDelay -= deltaTime;
+	AllocationScope allocationScope(AllocationTracker::ANIMATIONS);
 
-		if (s_puckRespawnDelay <= 0.0f)
-		{
-			if (IsPuckSpawnerFree())
-			{
-				s_puck->SetEnabled(true);
-				s_onNextRound.Invoke();
-			}
-		}
-	}
+	entity.SetRenderer(s_renderer);
+
+	entity.AddAnimation("Idle", FrameAnimation::CreateSingleFrame(s_puckTexture));
 }
 
 
-void Game::UpdatePlayers()
+void Game::DecorateGate(Entity &entity)
 {
-	s_player1->Update();
-	s_player2->Update();
+	AllocationScope allocationScope(AllocationTracker::ANIMATIONS);
+
+	entity.SetRenderer(s_renderer);
+
+	entity.AddAnimation("Idle", FrameAnimation::CreateSingleFrame(s_gateTexture));
+
+	{
+		Animation &addedAnimation = *entity.AddAnimation("Score", SinusoidalTransparencyAnimation::Create(s_gateScoreTexture, M_PI, k_gateBlinkFreauency));
+		addedAnimation.SetNextState("Idle");
+		addedAnimation.SetDuration(0.75f);
+	}
 }
 
 
-void Game::UpdatePhysics()
+void Game::RenderEntities(float interpolation)
 {
-	for (int i = 0; i < s_entities.size(); i++)
+	for (Entity& entity : s_world->GetEntities())
 	{
-		if (!s_entities[i].IsEnabled()) { continue; }
+		if (!entity.IsEnabled()) { continue; }
 
-		for (int j = i + 1; j < s_entities.size(); j++)
-		{
-			if (!s_entities[j].IsEnabled()) { continue; }
+		entity.Draw(interpolation);
+	}
+}
 
-			const float penetration = s_entities[i].Contact(s_entities[j]);
-			if (penetration > 0.0f)
-			{
-				s_entities[i].Collide(s_entities[j], penetration);
-			}
-		}
 
-		for (int j = 0; j <s_borders.size(); j++)
-		{
-			if (!s_entities[i].CanCollideWith(Entity::WALL_LAYER)) { continue; }
+void Game::RenderBorders()
+{
+	const std::vector<line>& borders = s_world->GetBorders();
 
-			if (s_entities[i].Contact(s_borders[j], k_wallCollisionMask))
-			{
-				s_entities[i].ReflectFrom(s_borders[j], Entity::WALL_LAYER, k_wallsVelocityConsumption);
-			}
-		}
+	for (int i = 0; i < borders.size(); i++)
+	{
+		int x1 = borders[i].point1.x * windowSize.x;
+		int y1 = (1.0f - borders[i].point1.y * windowRatio) * windowSize.y;
+		int x2 = borders[i].point2.x * windowSize.x;
+		int y2 = (1.0f - borders[i].point2.y * windowRatio) * windowSize.y;
+		SDL_RenderDrawLine(s_renderer, x1, y1, x2, y2);
 	}
 }
 
 
-void Game::UpdateEntities()
+void Game::RenderScore()
 {
-	for (int i = 0; i < s_entities.size(); i++)
+	SDL_RenderCopy(s_renderer, s_scoreTexture1, nullptr, &s_scoreRect1);
+	SDL_RenderCopy(s_renderer, s_scoreTexture2, nullptr, &s_scoreRect2);
+}
+
+
+void Game::RenderProfilerOverlay()
+{
+	if (!s_isProfilerOverlayVisible) { return; }
+
+	if (SDL_TICKS_PASSED(SDL_GetTicks(), s_profilerOverlayUpdateMoment + k_profilerOverlayUpdatePeriod))
 	{
-		if (!s_entities[i].IsEnabled()) { continue; }
+		UpdateProfilerOverlay();
+	}
 
-		s_entities[i].Update();
+	for (size_t i = 0; i < s_profilerOverlayTextures.size(); i++)
+	{
+		SDL_RenderCopy(s_renderer, s_profilerOverlayTextures[i], nullptr, &s_profilerOverlayRects[i]);
 	}
 }
 
 
-void Game::RenderEntities()
+void Game::UpdateProfilerOverlay()
 {
-	for (int i = 0; i < s_entities.size(); i++)
+	ClearProfilerOverlay();
+
+	char text[128];
+
+	for (int phase = 0; phase < Profiler::PHASE_COUNT; phase++)
 	{
-		if (!s_entities[i].IsEnabled()) { continue; }
+		const Profiler::Statistics statistics = Profiler::GetStatistics(static_cast<Profiler::Phase>(phase));
+
+		snprintf(text, sizeof(text), "%-15s p50 %6.3f p95 %6.3f p99 %6.3f max %6.3f ms", Profiler::GetPhaseName(static_cast<Profiler::Phase>(phase)), statistics.p50, statistics.p95, statistics.p99, statistics.max);
+
+		SDL_Surface *surface = TTF_RenderText_Blended(s_font, text, k_textColor);
+		if (surface == nullptr) { continue; }
 
-		s_entities[i].Draw();
+		const SDL_Rect rect = { 0, phase * k_profilerLineHeight, surface->w * k_profilerLineHeight / surface->h, k_profilerLineHeight };
+
+		s_profilerOverlayTextures.push_back(SDL_CreateTextureFromSurface(s_renderer, surface));
+		AllocationTracker::TrackTexture(s_profilerOverlayTextures.back());
+		s_profilerOverlayRects.push_back(rect);
+
+		SDL_FreeSurface(surface);
 	}
+
+	s_profilerOverlayUpdateMoment = SDL_GetTicks();
 }
 
 
-void Game::RenderBorders()
+void Game::ClearProfilerOverlay()
 {
-	for (int i = 0; i < s_borders.size(); i++)
+	for (SDL_Texture *texture : s_profilerOverlayTextures)
 	{
-		int x1 = s_borders[i].point1.x * windowSize.x;
-		int y1 = (1.0f - s_borders[i].point1.y * windowRatio) * windowSize.y;
-		int x2 = s_borders[i].point2.x * windowSize.x;
-		int y2 = (1.0f - s_borders[i].point2.y * windowRatio) * windowSize.y;
-		SDL_RenderDrawLine(s_renderer, x1, y1, x2, y2);
+		AllocationTracker::UntrackTexture(texture);
+		SDL_DestroyTexture(texture);
 	}
+
+	s_profilerOverlayTextures.clear();
+	s_profilerOverlayRects.clear();
 }
 
 
-void Game::RenderScore()
+void Game::ReportProfiler()
 {
-	s_scoreRect1.x = windowSize.x - k_scoreLetterWidth * s_count1Str.length();
-	s_scoreRect1.w = k_scoreLetterWidth * s_count1Str.length();
-	
-	s_scoreRect2.x = windowSize.x - k_scoreLetterWidth * s_count2Str.length();
-	s_scoreRect2.w = k_scoreLetterWidth * s_count2Str.length();
+	if (s_settings.profileFile.empty()) { return; }
 
-	SDL_RenderCopy(s_renderer, s_scoreTexture1, nullptr, &s_scoreRect1);
-	SDL_RenderCopy(s_renderer, s_scoreTexture2, nullptr, &s_scoreRect2);
+	for (int phase = 0; phase < Profiler::PHASE_COUNT; phase++)
+	{
+		const Profiler::Statistics statistics = Profiler::GetStatistics(static_cast<Profiler::Phase>(phase));
+		if (statistics.count == 0) { continue; }
+
+		std::cout << Profiler::GetPhaseName(static_cast<Profiler::Phase>(phase)) << ": p50 " << statistics.p50 << " p95 " << statistics.p95 << " p99 " << statistics.p99 << " max " << statistics.max << " ms\n";
+	}
+
+	Profiler::DumpCsv(s_settings.profileFile);
 }
 
 
-bool Game::IsPuckSpawnerFree()
+bool Game::ReportAllocations()
 {
-	for (int i = 0; i < s_entities.size(); i++)
+	if (!s_settings.isTrackingAllocations) { return true; }
+
+	for (int phase = 0; phase <= Profiler::PHASE_COUNT; phase++)
 	{
-		if (!s_entities[i].IsEnabled()) { continue; }
+		const AllocationTracker::Totals totals = AllocationTracker::GetPhaseTotals(static_cast<Profiler::Phase>(phase));
+		if (totals.count == 0) { continue; }
 
-		if (s_entities[i].Contact(s_puckSpawner) > 0.0f) { return false; }
+		const char* name = (phase < Profiler::PHASE_COUNT) ? Profiler::GetPhaseName(static_cast<Profiler::Phase>(phase)) : "Outside phases";
+		std::cout << "Allocations in " << name << ": " << totals.count << " (" << totals.bytes << " bytes)\n";
 	}
 
+	for (int subsystem = 0; subsystem < AllocationTracker::SUBSYSTEM_COUNT; subsystem++)
+	{
+		const AllocationTracker::Totals totals = AllocationTracker::GetSubsystemTotals(static_cast<AllocationTracker::Subsystem>(subsystem));
+		std::cout << AllocationTracker::GetSubsystemName(static_cast<AllocationTracker::Subsystem>(subsystem)) << ": " << totals.count << " (" << totals.bytes << " bytes)\n";
+	}
+
+	if (!s_settings.isAllocationTest) { return true; }
+
+	const AllocationTracker::Totals violations = AllocationTracker::GetViolations();
+
+	if (violations.count > 0)
+	{
+		const Profiler::Phase phase = AllocationTracker::GetFirstViolationPhase();
+		const char* name = (phase < Profiler::PHASE_COUNT) ? Profiler::GetPhaseName(phase) : "outside phases";
+
+		std::cerr << "Allocation test failed: " << violations.count << " allocations (" << violations.bytes << " bytes) after warm-up, first in " << name << "\n";
+		return false;
+	}
+
+	std::cout << "Allocation test passed: nothing allocated after " << AllocationTracker::k_warmupDuration << " s of warm-up\n";
 	return true;
 }
 
 
+void Game::PlaySound(Mix_Music *sound)
+{
+	Mix_PlayMusic(sound, 1);
+}
+
+
+void Game::UpdateScoreTexture(SDL_Texture*& texture, SDL_Rect& rect, unsigned int score)
+{
+	char text[16]; //formatted in place, scores change in collision listeners
+	const int length = snprintf(text, sizeof(text), "%u", score);
+
+	SDL_Surface *surface = TTF_RenderText_Blended(s_font, text, k_textColor);
+
+	if (texture) { AllocationTracker::UntrackTexture(texture); SDL_DestroyTexture(texture); }
+	texture = SDL_CreateTextureFromSurface(s_renderer, surface);
+	AllocationTracker::TrackTexture(texture);
+
+	SDL_FreeSurface(surface);
+
+	rect.x = windowSize.x - k_scoreLetterWidth * length;
+	rect.w = k_scoreLetterWidth * length;
+}
+
+
+void Game::ReportMatches()
+{
+	const std::vector<GameWorld::MatchResult>& results = s_matchScheduler->GetResults();
+	const unsigned long long ticks = s_matchScheduler->GetTotalTicks();
+	const double elapsed = static_cast<double>(s_simulationFinishCounter - s_simulationStartCounter) / SDL_GetPerformanceFrequency();
+
+	unsigned int wins1 = 0, wins2 = 0;
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const GameWorld::MatchResult& result = results[i];
+
+		if (result.score1 > result.score2) { wins1++; }
+		if (result.score2 > result.score1) { wins2++; }
+
+		std::cout << "Match " << (i + 1) << ": " << result.score1 << " - " << result.score2 << " (" << result.ticks << " ticks)\n";
+	}
+
+	std::cout << "Seeds: " << s_settings.seed << " - " << (s_settings.seed + results.size() - 1) << "\n";
+	std::cout << "Player 1 wins: " << wins1 << ", player 2 wins: " << wins2 << ", draws: " << (results.size() - wins1 - wins2) << "\n";
+	std::cout << "Ticks: " << ticks << " in " << elapsed << " s on " << s_matchScheduler->GetThreadCount() << " threads";
+
+	if (elapsed > 0.0) { std::cout << " (" << static_cast<Uint64>(ticks / elapsed) << " ticks/s)"; }
+
+	std::cout << "\n";
+}
+
+
+void Game::ReportInputLatency()
+{
+	if (s_input.GetDispatchedCount() == 0) { return; }
+
+	std::cout << "Input latency: " << s_input.GetAverageLatency() << " ms average, " << s_input.GetMaxLatency() << " ms max over " << s_input.GetDispatchedCount() << " events\n";
+}
+
+
 void Game::OnKeyDown(SDL_Scancode code)
 {
 	switch (code)
@@ -694,7 +790,7 @@ void Game::OnKeyDown(SDL_Scancode code)
 		case k_exitKeyCode: OnExitClick(); break;
 	}
 
-	s_player.OnKeyboardDown(code);
+	s_world->GetKeyboardController().OnKeyboardDown(code);
 }
 
 
@@ -704,9 +800,10 @@ void Game::OnKeyUp(SDL_Scancode code)
 	{
 		case k_restartKeyCode: OnRestartClick(); break;
 		case k_autopilotKeyCode: OnAutopilotClick(); break;
+		case k_profilerKeyCode: OnProfilerClick(); break;
 	}
 
-	s_player.OnKeyboardUp(code);
+	s_world->GetKeyboardController().OnKeyboardUp(code);
 }
 
 
@@ -718,7 +815,7 @@ void Game::OnExitClick()
 
 void Game::OnRestartClick()
 {
-	Mix_PlayMusic(s_scoreResetSound, 1);
+	PlaySound(s_scoreResetSound);
 
 	Restart();
 }
@@ -726,73 +823,45 @@ void Game::OnRestartClick()
 
 void Game::OnAutopilotClick()
 {
-	if (s_player1 == &s_player)
-	{
-		s_player1 = &s_bot2;
-	}
-	else
-	{
-		s_player1 = &s_player;
-	}
-}
-
-
-void Game::OnPlayerScore(Entity* entity1, Entity* entity2)
-{
-	Mix_PlayMusic(s_puckEntersGateSound, 1);
-
-	entity1->Play("Score");
-
-	s_puck->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.5f));
-	s_puck->SetVelocity(glm::vec2(0.0f, 0.0f));
-	s_puck->SetEnabled(false);
-
-	s_puckRespawnDelay = k_puckRespawnDelay;
+	s_world->SetAutopilot(!s_world->IsAutopilot());
 }
 
 
-void Game::OnPlayer1Score(Entity* entity1, Entity* entity2)
+void Game::OnProfilerClick()
 {
-	s_count1++;
-	s_count1Str = std::to_string(s_count1);
-
-	SDL_Surface *surface = TTF_RenderText_Blended(s_font, s_count1Str.c_str(), k_textColor);
+	s_isProfilerOverlayVisible = !s_isProfilerOverlayVisible;
 
-	s_scoreTexture1 = SDL_CreateTextureFromSurface(s_renderer, surface);
-
-	SDL_FreeSurface(surface);
+	if (s_isProfilerOverlayVisible)
+	{
+		UpdateProfilerOverlay();
+	}
+	else
+	{
+		ClearProfilerOverlay();
+	}
 }
 
 
-void Game::OnPlayer2Score(Entity* entity1, Entity* entity2)
+void Game::OnPlayerScore(unsigned int player)
 {
-	s_count2++;
-	s_count2Str = std::to_string(s_count2);
-
-	SDL_Surface *surface = TTF_RenderText_Blended(s_font, s_count2Str.c_str(), k_textColor);
-
-	s_scoreTexture2 = SDL_CreateTextureFromSurface(s_renderer, surface);
+	PlaySound(s_puckEntersGateSound);
 
-	SDL_FreeSurface(surface);
-}
-
-
-void Game::OnStickCollision(Entity* entity1, Entity* entity2)
-{
-	if (entity2 == s_puck)
+	if (player == 1)
 	{
-		entity1->PlayIfNotPlaying("Blink");
+		UpdateScoreTexture(s_scoreTexture1, s_scoreRect1, s_world->GetScore1());
+	}
+	else
+	{
+		UpdateScoreTexture(s_scoreTexture2, s_scoreRect2, s_world->GetScore2());
 	}
 }
 
 
-void Game::OnPuckCollision(Entity* entity, Entity::mask_t layerMask)
+void Game::OnPuckCollision(Entity::mask_t layerMask)
 {
 	switch (layerMask)
 	{
-		case Entity::WALL_LAYER: Mix_PlayMusic(s_puckCollidesWallSound, 1); break;
-		case Entity::STICK_LAYER: Mix_PlayMusic(s_puckCollidesStickSound, 1); break;
+		case Entity::WALL_LAYER: PlaySound(s_puckCollidesWallSound); break;
+		case Entity::STICK_LAYER: PlaySound(s_puckCollidesStickSound); break;
 	}
-
-	s_onPuckCollision.Invoke();
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <SDL.h>
@@ -8,16 +10,20 @@
 
 #include <glm/glm.hpp>
 
-#include "Controller.h"
+#include "AllocationTracker.h"
 #include "Entity.h"
+#include "GameWorld.h"
+#include "InputQueue.h"
+#include "MatchScheduler.h"
+#include "Profiler.h"
+#include "Replay.h"
 #include "Resource.h"
-#include "Event.h"
+#include "Settings.h"
 
 
 class Game //static
 {
 public:
-	static float deltaTime; //seconds
 	static SDL_DisplayMode displayMode;
 	static glm::ivec2 windowPosition;
 	static glm::ivec2 windowSize;
@@ -25,8 +31,10 @@ public:
 	static float windowRatio;
 	static float reverseWindowRatio;
 
-	static bool Init();
-	static void Exit();
+	static bool Init(const Settings& settings);
+	static bool Exit(); //false if the allocation test failed
+
+	static void RunMatches(); //headless
 
 	static void StartFrame();
 	static void ProcessEvents();
@@ -36,19 +44,28 @@ public:
 
 	static void Restart();
 
-	static Entity* CreateStick(SDL_Texture *texture, SDL_Texture *animationSheet);
-	static Entity* CreatePuck();
-	static Entity* CreateGate();
-
 	inline static bool IsEnded() { return s_isEnded; }
-
-	static Event<void()> s_onNextRound;
-	static Event<void()> s_onPuckCollision;
+	inline static bool IsHeadless() { return s_settings.isHeadless; }
+	inline static bool IsRecording() { return !s_settings.recordFile.empty(); }
 
 private:
+	static Settings s_settings;
+
 	static bool s_isEnded;
 	static Uint32 s_frameStartMoment;
 
+	static Uint64 s_lastUpdateCounter;
+	static double s_accumulatedTime; //seconds of real time not yet simulated
+	static float s_interpolation; //render position between two last physics states, [0; 1]
+
+	static InputQueue s_input;
+	static Replay s_replay; //filled only when recording
+
+	static std::unique_ptr<GameWorld> s_world;
+	static std::unique_ptr<MatchScheduler> s_matchScheduler;
+	static Uint64 s_simulationStartCounter;
+	static Uint64 s_simulationFinishCounter;
+
 	static SDL_Window* s_window;
 	static SDL_Renderer* s_renderer;
 	static SDL_Rect s_scoreRect1;
@@ -57,16 +74,6 @@ private:
 	static float s_desiredFPS;
 	static Uint32 s_desiredFramePeriod;
 
-	static KeyboardController s_player;
-	static AIController s_bot;
-	static AIController s_bot2;
-
-	static Controller *s_player1, *s_player2;
-	static unsigned int s_count1, s_count2;
-
-	static std::vector<Entity> s_entities;
-	static std::vector<line> s_borders;
-
 	static const std::vector<Resource<SDL_Texture*>> k_textureResources;
 	static const std::vector<Resource<Mix_Music*>> k_soundResources;
 	static const Resource<TTF_Font*> k_fontResource;
@@ -85,45 +92,49 @@ private:
 	static SDL_Texture* s_scoreTexture1;
 	static SDL_Texture* s_scoreTexture2;
 
+	static bool s_isProfilerOverlayVisible;
+	static Uint32 s_profilerOverlayUpdateMoment;
+	static std::vector<SDL_Texture*> s_profilerOverlayTextures; //one line per phase
+	static std::vector<SDL_Rect> s_profilerOverlayRects;
+
 	static Mix_Music *s_puckCollidesWallSound;
 	static Mix_Music *s_puckCollidesStickSound;
 	static Mix_Music *s_puckEntersGateSound;
 	static Mix_Music *s_scoreResetSound;
 
-	static Entity *s_stick1, *s_stick2, *s_puck;
-
-	static circle s_puckSpawner;
-
 
 	static bool InitCore();
 	static bool InitTextures();
 	static bool InitAudio();
-	static bool InitPlayground();
-	static bool InitWalls();
+	static bool InitWorld();
 	static bool InitInterface();
 
-	static Entity& AddEntity();
-
-	static void UpdatePuck();
-	static void UpdatePlayers();
-	static void UpdatePhysics();
-	static void UpdateEntities();
+	static void DecorateStick(Entity &entity, SDL_Texture *texture, SDL_Texture *animationSheet);
+	static void DecoratePuck(Entity &entity);
+	static void DecorateGate(Entity &entity);
 
-	static void RenderEntities();
+	static void RenderEntities(float interpolation);
 	static void RenderBorders();
 	static void RenderScore();
-	
-	static bool IsPuckSpawnerFree();
+	static void RenderProfilerOverlay();
+
+	static void UpdateProfilerOverlay();
+	static void ClearProfilerOverlay();
+	static void ReportProfiler();
+	static bool ReportAllocations(); //false if anything was allocated after warm-up in the allocation test
+
+	static void PlaySound(Mix_Music *sound);
+	static void UpdateScoreTexture(SDL_Texture*& texture, SDL_Rect& rect, unsigned int score);
+	static void ReportMatches();
+	static void ReportInputLatency();
 
 	static void OnKeyDown(SDL_Scancode code);
 	static void OnKeyUp(SDL_Scancode code);
 	static void OnExitClick();
 	static void OnRestartClick();
 	static void OnAutopilotClick();
+	static void OnProfilerClick();
 
-	static void OnPlayerScore(Entity*, Entity*);
-	static void OnPlayer1Score(Entity*, Entity*);
-	static void OnPlayer2Score(Entity*, Entity*);
-	static void OnStickCollision(Entity* entity1, Entity* entity2);
-	static void OnPuckCollision(Entity* entity, Entity::mask_t layerMask);
+	static void OnPlayerScore(unsigned int player);
+	static void OnPuckCollision(Entity::mask_t layerMask);
 };
\ No newline at end of file
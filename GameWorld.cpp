@@ -0,0 +1,883 @@
+#include "GameWorld.h"
+
+#include <climits>
+
+#include "AllocationTracker.h"
+#include "Profiler.h"
+
+
+namespace
+{
+	const size_t k_playgroundEntityCount = 5; //sticks, puck and gates; arena pucks follow them
+	const size_t k_reservedPairsPerBody = 4; //per step storage is sized for that many contacts up front, crowds beyond it grow it
+
+	const float k_maxMatchDuration = 600.0f; // seconds; match is declared a draw after that
+
+	const float k_stickMovePower = 8.75f;
+	const float k_wallsVelocityConsumption = 0.25f;
+
+	const float k_wallsWidth = 0.05f;
+	const float k_gateWidth = 0.3f;
+
+	const float k_stickRadius = 0.075f;
+	const float k_stickFriction = 3.15f;
+	const float k_stickMass = 5.0f;
+
+	const float k_puckRadius = 0.025f;
+	const float k_puckFriction = 0.11f;
+	const float k_puckMass = 1.25f;
+
+	const float k_puckRespawnDelay = 1.0f; // seconds
+
+	const float k_maxLeapDuration = 1.0f; // seconds; bounds are inflated by the travel over that time when idle ticks are searched
+	const unsigned int k_minLeapTicks = 4; //shorter leaps don't pay off the search
+	const unsigned int k_leapRetryTicks = 16; //after a failed search
+	const float k_leapMargin = 0.001f; //gap kept between shapes, touching ones are left to the fixed step
+
+	const float k_arenaPuckMaxSpeed = 1.0f;
+	const float k_arenaFillRatio = 0.2f; //of playground area covered by arena pucks; they shrink when there are many
+
+	const unsigned int k_stickCollisionMask = Entity::PUCK_LAYER | Entity::WALL_LAYER | Entity::ARENA_PUCK_LAYER;
+	const unsigned int k_puckCollisionMask = Entity::STICK_LAYER | Entity::WALL_LAYER | Entity::GATE_LAYER | Entity::ARENA_PUCK_LAYER;
+	const unsigned int k_wallCollisionMask = Entity::STICK_LAYER | Entity::PUCK_LAYER | Entity::ARENA_PUCK_LAYER;
+	const unsigned int k_gateCollisionMask = Entity::PUCK_LAYER;
+	const unsigned int k_arenaPuckCollisionMask = Entity::STICK_LAYER | Entity::PUCK_LAYER | Entity::WALL_LAYER | Entity::ARENA_PUCK_LAYER;
+
+	//by layer index, that is the bit of the layer mask
+	constexpr unsigned int k_layerCollisionMasks[Entity::LAYER_COUNT] =
+	{
+		k_stickCollisionMask,
+		k_puckCollisionMask,
+		k_wallCollisionMask,
+		k_gateCollisionMask,
+		k_arenaPuckCollisionMask,
+	};
+
+	constexpr CollisionMatrix k_collisionMatrix(k_layerCollisionMasks);
+	static_assert(k_collisionMatrix.IsSymmetric(), "Collision masks of layers have to agree both ways");
+
+	const size_t k_wallLayer = CollisionMatrix::LayerOf(Entity::WALL_LAYER);
+
+	const Uint32 k_noIndex = 0xFFFFFFFF; //body isn't in the list
+
+	const Uint64 k_fnvOffsetBasis = 14695981039346656037ull;
+	const Uint64 k_fnvPrime = 1099511628211ull;
+
+
+	inline BodyStore::handle_t BodyOf(BodyStore::handle_t body) { return body; }
+	inline BodyStore::handle_t BodyOf(const Entity* entity) { return entity->GetBody(); }
+
+
+	//indices are places in the list by body, kept up to date
+	template <typename Item>
+	void PushBack(std::vector<Item>& items, std::vector<Uint32>& indices, const Item& item)
+	{
+		indices[BodyOf(item)] = static_cast<Uint32>(items.size());
+		items.push_back(item);
+	}
+
+
+	//the last item takes the place of the removed one
+	template <typename Item>
+	void SwapRemove(std::vector<Item>& items, std::vector<Uint32>& indices, BodyStore::handle_t body)
+	{
+		const Uint32 index = indices[body];
+
+		items[index] = items.back();
+		indices[BodyOf(items[index])] = index;
+		items.pop_back();
+		indices[body] = k_noIndex;
+	}
+
+
+	//FNV-1a over raw bytes; floats are hashed bitwise, so any drift is caught
+	inline void Hash(Uint64& hash, const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * k_fnvPrime;
+		}
+	}
+}
+
+
+GameWorld::GameWorld(float deltaTime, float reverseWindowRatio, unsigned int seed, unsigned int arenaPuckCount, unsigned int entityCapacity) :
+	deltaTime(deltaTime),
+	reverseWindowRatio(reverseWindowRatio),
+	m_seed(seed),
+	m_random(seed),
+	m_player(*this),
+	m_bot(*this),
+	m_bot2(*this),
+	m_player1(&m_player),
+	m_player2(&m_bot),
+	m_score1(0),
+	m_score2(0),
+	m_ticks(0),
+	m_puckRespawnDelay(0.0f),
+	m_leapCooldown(0),
+	m_broadphase(k_collisionMatrix),
+	m_collisionEvents(FrameAllocator<CollisionEvent>(m_stepArena))
+{
+	const size_t capacity = glm::max<size_t>(entityCapacity, k_playgroundEntityCount + arenaPuckCount);
+
+	{
+		AllocationScope allocationScope(AllocationTracker::ENTITIES);
+
+		m_bodies.Reserve(capacity);
+		m_entities.Reserve(capacity); //entities never move, pointers to them stay valid until they are despawned
+		m_despawnedEntities.reserve(capacity);
+		m_animatedIndices.reserve(capacity);
+		m_animatedEntities.reserve(capacity); //holds every entity at most, listeners starting animations never grow it
+		m_arenaPuckIndices.reserve(capacity);
+		m_arenaPucks.reserve(capacity);
+		m_layerIndices.reserve(capacity);
+
+		for (std::vector<BodyStore::handle_t>& layerBodies : m_layerBodies) { layerBodies.reserve(capacity); }
+	}
+
+	const size_t pairCapacity = capacity * k_reservedPairsPerBody;
+
+	m_broadphase.Reserve(capacity, pairCapacity);
+	m_narrowphase.Reserve(capacity, pairCapacity);
+	m_wallContacts.Reserve(capacity);
+	m_stepArena.Reserve(pairCapacity * sizeof(CollisionEvent));
+
+	InitPlayground();
+	InitWalls();
+	InitArena(arenaPuckCount);
+}
+
+
+void GameWorld::Restart()
+{
+	m_score1 = 0;
+	m_score2 = 0;
+	m_ticks = 0;
+
+	m_stick1->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.25f));
+	m_stick2->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.75f));
+
+	m_puck->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.5f));
+	m_puck->SetVelocity(glm::vec2(0.0f, 0.0f));
+	m_puck->SetEnabled(true);
+
+	ScatterArenaPucks();
+
+	m_onNextRound.Invoke();
+}
+
+
+void GameWorld::Step()
+{
+	m_stepArena.Reset(); //containers on it were emptied at the end of the last step
+
+	{
+		ProfileScope scope(Profiler::UPDATE_PUCK);
+		UpdatePuck();
+	}
+
+	{
+		ProfileScope scope(Profiler::UPDATE_PLAYERS);
+		UpdatePlayers();
+	}
+
+	{
+		ProfileScope scope(Profiler::UPDATE_PHYSICS);
+		UpdatePhysics();
+	}
+
+	{
+		ProfileScope scope(Profiler::UPDATE_ENTITIES);
+		UpdateEntities();
+	}
+
+	{
+		ProfileScope scope(Profiler::DISPATCH_EVENTS);
+		DispatchCollisionEvents();
+	}
+
+	m_ticks++;
+}
+
+
+unsigned int GameWorld::StepToNextEvent()
+{
+	if (m_leapCooldown > 0)
+	{
+		m_leapCooldown--;
+		Step();
+		return 1;
+	}
+
+	unsigned int ticks;
+
+	{
+		ProfileScope scope(Profiler::UPDATE_PHYSICS);
+		ticks = FindIdleTicks();
+	}
+
+	if (ticks < k_minLeapTicks)
+	{
+		m_leapCooldown = k_leapRetryTicks;
+		Step(); //broadphase bounds are restored by it
+		return 1;
+	}
+
+	Leap(ticks);
+	return ticks;
+}
+
+
+bool GameWorld::IsMatchFinished(unsigned int scoreLimit) const
+{
+	if (m_score1 >= scoreLimit || m_score2 >= scoreLimit) { return true; }
+
+	return m_ticks * deltaTime >= k_maxMatchDuration;
+}
+
+
+GameWorld::MatchResult GameWorld::GetResult() const
+{
+	return { m_score1, m_score2, m_ticks };
+}
+
+
+Uint64 GameWorld::GetStateChecksum() const
+{
+	Uint64 hash = k_fnvOffsetBasis;
+
+	for (const Entity& entity : m_entities)
+	{
+		const glm::vec2& position = entity.GetPosition();
+		const glm::vec2& velocity = entity.GetVelocity();
+		const bool isEnabled = entity.IsEnabled();
+
+		Hash(hash, &position, sizeof(position));
+		Hash(hash, &velocity, sizeof(velocity));
+		Hash(hash, &isEnabled, sizeof(isEnabled));
+	}
+
+	Hash(hash, &m_score1, sizeof(m_score1));
+	Hash(hash, &m_score2, sizeof(m_score2));
+	Hash(hash, &m_puckRespawnDelay, sizeof(m_puckRespawnDelay));
+
+	return hash;
+}
+
+
+Uint32 GameWorld::GetDecisionChecksum() const
+{
+	Uint64 hash = k_fnvOffsetBasis;
+
+	Hash(hash, &m_player1->GetMoveDirection(), sizeof(glm::vec2));
+	Hash(hash, &m_player2->GetMoveDirection(), sizeof(glm::vec2));
+
+	return static_cast<Uint32>(hash ^ (hash >> 32));
+}
+
+
+void GameWorld::Animate(float elapsedTime)
+{
+	for (size_t i = 0; i < m_animatedEntities.size(); )
+	{
+		const BodyStore::handle_t handle = m_animatedEntities[i];
+		Entity& entity = m_entities[handle];
+
+		if (entity.IsEnabled()) { entity.Animate(elapsedTime); }
+
+		if (entity.IsAnimating())
+		{
+			i++;
+			continue;
+		}
+
+		SwapRemove(m_animatedEntities, m_animatedIndices, handle);
+	}
+}
+
+
+void GameWorld::StartAnimating(BodyStore::handle_t entity)
+{
+	if (m_animatedIndices[entity] != k_noIndex) { return; }
+
+	PushBack(m_animatedEntities, m_animatedIndices, entity);
+}
+
+
+Entity& GameWorld::SpawnEntity(Entity::mask_t layerMask, Entity::mask_t collisionMask)
+{
+	SDL_assert(!m_entities.IsFull());
+
+	AllocationScope allocationScope(AllocationTracker::ENTITIES);
+
+	const size_t layer = CollisionMatrix::LayerOf(layerMask);
+	SDL_assert(layer < Entity::LAYER_COUNT && layerMask == (1u << layer)); //one layer per body
+
+	//entity and its body share the slot index, so a reused slot reuses the body
+	const BodyStore::handle_t body = m_entities.GetNextIndex();
+
+	if (body == m_bodies.GetCount())
+	{
+		m_bodies.Add();
+		m_broadphase.Add(static_cast<Uint32>(body), layer);
+		m_animatedIndices.push_back(k_noIndex);
+		m_arenaPuckIndices.push_back(k_noIndex);
+		m_layerIndices.push_back(k_noIndex);
+	}
+	else
+	{
+		m_bodies.Reset(body);
+		m_broadphase.SetLayer(body, layer);
+	}
+
+	Entity& entity = m_entities[m_entities.Emplace(*this, body).index];
+	entity.SetLayerMask(layerMask);
+	entity.SetCollisionMask(collisionMask);
+
+	PushBack(m_layerBodies[layer], m_layerIndices, body);
+
+	return entity;
+}
+
+
+Entity& GameWorld::SpawnArenaPuck(const glm::vec2& position)
+{
+	Entity* puck = CreateArenaPuck();
+	puck->SetPosition(position);
+
+	PushBack(m_arenaPucks, m_arenaPuckIndices, puck);
+
+	return *puck;
+}
+
+
+void GameWorld::DespawnEntity(EntityHandle handle)
+{
+	Entity* entity = m_entities.Get(handle);
+	if (!entity) { return; }
+
+	const BodyStore::handle_t body = handle.index;
+	SDL_assert(body >= k_playgroundEntityCount); //controllers and listeners point to playground entities
+
+	if (m_layerIndices[body] == k_noIndex) { return; } //despawned already, waits for the end of the step
+	SwapRemove(m_layerBodies[CollisionMatrix::LayerOf(entity->GetLayerMask())], m_layerIndices, body);
+
+	m_bodies.Remove(body); //cached contacts of the body go stale with it
+	m_broadphase.SetEnabled(body, false);
+
+	if (m_arenaPuckIndices[body] != k_noIndex) { SwapRemove(m_arenaPucks, m_arenaPuckIndices, body); }
+	m_despawnedEntities.push_back(handle);
+}
+
+
+void GameWorld::SetAutopilot(bool enabled)
+{
+	m_player1 = enabled ? static_cast<Controller*>(&m_bot2) : &m_player;
+}
+
+
+void GameWorld::SetPhysicsThreadCount(unsigned int threadCount)
+{
+	m_physicsPool.reset((threadCount != 1) ? new ThreadPool(threadCount) : nullptr);
+}
+
+
+void GameWorld::InitPlayground()
+{
+	m_stick1 = CreateStick();
+	m_stick1->SetName("Stick 1");
+
+	m_stick2 = CreateStick();
+	m_stick2->SetName("Stick 2");
+
+	m_puck = CreatePuck();
+
+	m_gate1 = CreateGate();
+	m_gate1->m_onCollision.AddListener([this](Entity* gate, Entity* puck) { OnPlayerScore(gate, puck); m_score2++; m_onScore.Invoke(2u); });
+	m_gate1->SetSize(glm::vec2(k_gateWidth, k_wallsWidth * 0.5f));
+	m_gate1->SetAnchoredPosition(glm::vec2(0.0f, k_wallsWidth * 0.25f), glm::vec2(0.5f, 0.0f));
+
+	m_gate2 = CreateGate();
+	m_gate2->m_onCollision.AddListener([this](Entity* gate, Entity* puck) { OnPlayerScore(gate, puck); m_score1++; m_onScore.Invoke(1u); });
+	m_gate2->SetSize(glm::vec2(k_gateWidth, k_wallsWidth * 0.5f));
+	m_gate2->SetAnchoredPosition(glm::vec2(0.0f, -k_wallsWidth * 0.25f), glm::vec2(0.5f, 1.0f));
+
+	m_player.SetControlTarget(m_stick1);
+	m_player.SetMoveForce(k_stickMovePower);
+	m_player.SetArea(rectangle(glm::vec2(0.5f, 0.25f * reverseWindowRatio), glm::vec2(1.0f, reverseWindowRatio * 0.48f)));
+
+	m_bot.SetControlTarget(m_stick2);
+	m_bot.SetMoveForce(k_stickMovePower);
+	m_bot.SetArea(rectangle(glm::vec2(0.5f, 0.75f * reverseWindowRatio), glm::vec2(1.0f, reverseWindowRatio * 0.54f)));
+
+	m_bot2.SetControlTarget(m_stick1);
+	m_bot2.SetMoveForce(k_stickMovePower);
+	m_bot2.SetArea(rectangle(glm::vec2(0.5f, 0.25f * reverseWindowRatio), glm::vec2(1.0f, reverseWindowRatio * 0.54f)));
+
+	SDL_assert(m_gate2->GetShape().m_type == shape::RECTANGLE);
+	m_bot.SetPuck(m_puck);
+	m_bot.SetOwnGateRectangle(m_gate2->GetShape().m_data.m_rectangle);
+	m_bot.SetOpponentGateRectangle(m_gate1->GetShape().m_data.m_rectangle);
+
+	SDL_assert(m_gate1->GetShape().m_type == shape::RECTANGLE);
+	m_bot2.SetPuck(m_puck);
+	m_bot2.SetOwnGateRectangle(m_gate1->GetShape().m_data.m_rectangle);
+	m_bot2.SetOpponentGateRectangle(m_gate2->GetShape().m_data.m_rectangle);
+
+	m_puckSpawner.position = glm::vec2(0.5f, reverseWindowRatio * 0.5f);
+	m_puckSpawner.radius = k_puckRadius * 2.5f;
+}
+
+
+void GameWorld::InitWalls()
+{
+	const std::vector<glm::vec2> borderStrip =
+	{
+		glm::vec2(k_wallsWidth, k_wallsWidth),
+		glm::vec2(k_wallsWidth, reverseWindowRatio - k_wallsWidth),
+		glm::vec2(0.5f - k_gateWidth * 0.5f, reverseWindowRatio - k_wallsWidth),
+		glm::vec2(0.5f - k_gateWidth * 0.5f, reverseWindowRatio),
+		glm::vec2(0.5f + k_gateWidth * 0.5f, reverseWindowRatio),
+		glm::vec2(0.5f + k_gateWidth * 0.5f, reverseWindowRatio - k_wallsWidth),
+		glm::vec2(1.0f - k_wallsWidth, reverseWindowRatio - k_wallsWidth),
+		glm::vec2(1.0f - k_wallsWidth, k_wallsWidth),
+		glm::vec2(0.5f + k_gateWidth * 0.5f, k_wallsWidth),
+		glm::vec2(0.5f + k_gateWidth * 0.5f, 0.0f),
+		glm::vec2(0.5f - k_gateWidth * 0.5f, 0.0f),
+		glm::vec2(0.5f - k_gateWidth * 0.5f, k_wallsWidth),
+	};
+
+	for (int i = 0; i < borderStrip.size() - 1; i++)
+	{
+		m_borders.push_back(line(borderStrip[i], borderStrip[i+1]));
+	}
+
+	m_borders.push_back(line(borderStrip[borderStrip.size() - 1], borderStrip[0]));
+
+	m_borderSet.Build(m_borders);
+}
+
+
+void GameWorld::InitArena(unsigned int puckCount)
+{
+	m_arenaPuckRadius = k_puckRadius;
+
+	if (puckCount == 0) { return; }
+
+	const float area = (1.0f - 2.0f * k_wallsWidth) * (reverseWindowRatio - 2.0f * k_wallsWidth);
+	m_arenaPuckRadius = glm::min(k_puckRadius, sqrtf(area * k_arenaFillRatio / (static_cast<float>(M_PI) * puckCount)));
+
+	for (unsigned int i = 0; i < puckCount; i++)
+	{
+		SpawnArenaPuck(glm::vec2(0.0f, 0.0f)); //scattered on restart
+	}
+}
+
+
+Entity* GameWorld::CreateStick()
+{
+	Entity &entity = SpawnEntity(Entity::STICK_LAYER, k_stickCollisionMask);
+
+	entity.SetMass(k_stickMass);
+	entity.SetShape(shape::CIRCLE);
+	entity.SetSize(glm::vec2(k_stickRadius * 2.0f));
+	entity.SetFrinction(k_stickFriction);
+	entity.m_onCollision.AddListener([this](Entity* entity1, Entity* entity2) { OnStickCollision(entity1, entity2); });
+
+	return &entity;
+}
+
+
+Entity* GameWorld::CreatePuck()
+{
+	Entity &entity = SpawnEntity(Entity::PUCK_LAYER, k_puckCollisionMask);
+
+	entity.SetName("Puck");
+	entity.SetMass(k_puckMass);
+	entity.SetShape(shape::CIRCLE);
+	entity.SetSize(glm::vec2(k_puckRadius * 2.0f));
+	entity.SetFrinction(k_puckFriction);
+	entity.m_onCollisionWithLayer.AddListener([this](Entity* entity, Entity::mask_t layerMask) { OnPuckCollision(entity, layerMask); });
+	entity.SetEnabled(false);
+
+	return &entity;
+}
+
+
+Entity* GameWorld::CreateGate()
+{
+	Entity &entity = SpawnEntity(Entity::GATE_LAYER, k_gateCollisionMask);
+
+	entity.SetMass(0.0f);
+	entity.SetShape(shape::RECTANGLE);
+	entity.SetStatic(true);
+
+	return &entity;
+}
+
+
+Entity* GameWorld::CreateArenaPuck()
+{
+	Entity &entity = SpawnEntity(Entity::ARENA_PUCK_LAYER, k_arenaPuckCollisionMask);
+
+	entity.SetName("Arena puck");
+	entity.SetMass(k_puckMass);
+	entity.SetShape(shape::CIRCLE);
+	entity.SetSize(glm::vec2(m_arenaPuckRadius * 2.0f));
+	entity.SetFrinction(k_puckFriction);
+
+	return &entity;
+}
+
+
+void GameWorld::ScatterArenaPucks()
+{
+	const float margin = k_wallsWidth + k_puckRadius; //arena pucks are never bigger than the puck
+
+	for (Entity* puck : m_arenaPucks)
+	{
+		const float x = margin + (1.0f - 2.0f * margin) * 0.0001f * (Random() % 10000);
+		const float y = margin + (reverseWindowRatio - 2.0f * margin) * 0.0001f * (Random() % 10000);
+		const float angle = 2.0f * static_cast<float>(M_PI) * 0.0001f * (Random() % 10000);
+		const float speed = k_arenaPuckMaxSpeed * 0.0001f * (Random() % 10000);
+
+		puck->SetPosition(glm::vec2(x, y));
+		puck->SetVelocity(glm::vec2(cosf(angle), sinf(angle)) * speed);
+	}
+}
+
+
+void GameWorld::UpdatePuck()
+{
+	if (!m_puck->IsEnabled())
+	{
+		m_puckRespawnDelay -= deltaTime;
+
+		if (m_puckRespawnDelay <= 0.0f)
+		{
+			if (IsPuckSpawnerFree())
+			{
+				m_puck->SetEnabled(true);
+				m_onNextRound.Invoke();
+			}
+		}
+	}
+}
+
+
+void GameWorld::UpdatePlayers()
+{
+	m_player1->Update();
+	m_player2->Update();
+}
+
+
+void GameWorld::UpdatePhysics()
+{
+	for (size_t i = 0; i < m_bodies.GetCount(); i++)
+	{
+		const bool isEnabled = m_bodies.IsEnabled(i);
+
+		m_broadphase.SetEnabled(i, isEnabled);
+		if (!isEnabled || m_bodies.IsSleeping(i)) { continue; } //bounds of sleeping bodies don't change
+
+		glm::vec2 min, max;
+		m_bodies.SweptBounds(i, deltaTime, min, max);
+		m_broadphase.Update(i, min, max);
+	}
+
+	m_narrowphase.Sort(m_broadphase.FindPairs(), m_bodies);
+
+	m_narrowphase.Run(m_bodies, deltaTime, [this](BodyStore::handle_t body1, BodyStore::handle_t body2, const manifold& contact)
+	{
+		m_entities[body1].Collide(m_entities[body2], contact);
+	},
+	[this](BodyStore::handle_t body1, BodyStore::handle_t body2, const manifold& contact, ContactCache::Phase phase)
+	{
+		m_collisionEvents.push_back({ body1, body2, static_cast<CollisionEvent::Kind>(CollisionEvent::BEGIN + phase), contact });
+	},
+	m_physicsPool.get());
+
+	UpdateWalls();
+}
+
+
+void GameWorld::UpdateWalls()
+{
+	m_wallContacts.Begin();
+
+	for (size_t layer = 0; layer < Entity::LAYER_COUNT; layer++)
+	{
+		if (!k_collisionMatrix.CanCollide(layer, k_wallLayer)) { continue; }
+
+		for (const BodyStore::handle_t body : m_layerBodies[layer])
+		{
+			if (m_bodies.IsAwake(body)) { CollideWithWalls(body); }
+		}
+	}
+
+	m_wallContacts.End([this](Uint32 body, Uint32) { return m_bodies.generations[body]; }, [this](const ContactCache::Entry& entry, ContactCache::Phase phase)
+	{
+		m_collisionEvents.push_back({ entry.key1, entry.key2, static_cast<CollisionEvent::Kind>(CollisionEvent::WALL_BEGIN + phase), entry.contact });
+	});
+}
+
+
+void GameWorld::CollideWithWalls(BodyStore::handle_t body)
+{
+	if (m_bodies.shapeTypes[body] != shape::CIRCLE)
+	{
+		for (size_t j = 0; j < m_borders.size(); j++)
+		{
+			CollideWithWall(body, j);
+		}
+
+		return;
+	}
+
+	//whatever the body touches during the step is within that reach of its current position
+	const float reach = m_bodies.radii[body] + glm::length(m_bodies.velocities[body]) * deltaTime;
+
+	Uint32 mask = m_borderSet.Test(m_bodies.positions[body], reach, nullptr);
+
+	for (size_t j = 0; mask != 0; j++, mask >>= 1)
+	{
+		if (mask & 1) { CollideWithWall(body, j); }
+	}
+}
+
+
+void GameWorld::CollideWithWall(BodyStore::handle_t body, size_t border)
+{
+	//borders never move, the body alone decides whether the last contact still holds
+	const glm::vec2 displacement = m_bodies.velocities[body] * deltaTime;
+	ContactCache::Entry& entry = m_wallContacts.Track(static_cast<Uint32>(body), static_cast<Uint32>(border), m_bodies.generations[body], m_bodies.positions[body], displacement, glm::vec2(0.0f, 0.0f));
+
+	if (!entry.isRevalidated) { entry.contact = m_bodies.Contact(body, m_borders[border], deltaTime); }
+
+	if (entry.contact.isHit)
+	{
+		m_entities[body].ReflectFrom(entry.contact, k_wallsVelocityConsumption);
+	}
+}
+
+
+void GameWorld::UpdateEntities()
+{
+	m_bodies.Integrate(deltaTime);
+}
+
+
+unsigned int GameWorld::FindIdleTicks()
+{
+	const unsigned long long lastTick = static_cast<unsigned long long>(k_maxMatchDuration / deltaTime);
+	if (m_ticks >= lastTick) { return 0; }
+
+	unsigned int ticks = static_cast<unsigned int>(glm::min(static_cast<unsigned long long>(k_maxLeapDuration / deltaTime), lastTick - m_ticks));
+
+	ticks = glm::min(ticks, glm::min(m_player1->GetIdleTicks(), m_player2->GetIdleTicks()));
+
+	if (!m_puck->IsEnabled()) //puck respawns on the tick its delay runs out
+	{
+		const float respawnTicks = floorf(m_puckRespawnDelay / deltaTime) - 1.0f;
+		ticks = (respawnTicks > 0.0f) ? glm::min(ticks, static_cast<unsigned int>(respawnTicks)) : 0;
+	}
+
+	if (ticks < k_minLeapTicks) { return 0; }
+
+	//bounds grow by the whole travel over the leap, bodies that don't overlap then can't meet sooner
+	const float duration = deltaTime * static_cast<float>(ticks);
+
+	for (size_t i = 0; i < m_bodies.GetCount(); i++)
+	{
+		const bool isEnabled = m_bodies.IsEnabled(i);
+
+		m_broadphase.SetEnabled(i, isEnabled);
+		if (!m_bodies.IsAwake(i)) { continue; }
+
+		const bool isCircle = m_bodies.shapeTypes[i] == shape::CIRCLE;
+		const float speed = glm::length(m_bodies.velocities[i]);
+
+		if (!isCircle && speed > 0.0f) { return 0; } //walls are measured for circles only, still shapes never reach them
+
+		const glm::vec2 travel(speed * duration);
+		glm::vec2 min, max;
+
+		m_bodies.Bounds(i, min, max);
+		m_broadphase.Update(i, min - travel, max + travel);
+
+		if (!isCircle || !(m_bodies.collisionMasks[i] & Entity::WALL_LAYER)) { continue; }
+
+		const glm::vec2& center = m_bodies.positions[i];
+		const float radius = m_bodies.radii[i];
+		glm::vec2 nearestPoints[BorderSet::k_capacity];
+
+		Uint32 mask = m_borderSet.Test(center, radius + travel.x + k_leapMargin, nearestPoints);
+
+		for (size_t j = 0; mask != 0; j++, mask >>= 1)
+		{
+			if (mask & 1) { ticks = glm::min(ticks, FindIdleTicks(glm::distance(center, nearestPoints[j]) - radius, speed)); }
+		}
+	}
+
+	for (const Broadphase::Pair& pair : m_broadphase.FindPairs())
+	{
+		const BodyStore::handle_t body1 = pair.key1;
+		const BodyStore::handle_t body2 = pair.key2;
+
+		if (!m_bodies.IsAwake(body1) && !m_bodies.IsAwake(body2)) { continue; }
+		if (!(m_bodies.layerMasks[body1] & m_bodies.collisionMasks[body2])) { continue; }
+
+		float gap;
+
+		if (m_bodies.shapeTypes[body1] == shape::CIRCLE && m_bodies.shapeTypes[body2] == shape::CIRCLE)
+		{
+			gap = glm::distance(m_bodies.positions[body1], m_bodies.positions[body2]) - m_bodies.radii[body1] - m_bodies.radii[body2];
+		}
+		else //separation of bounds never exceeds the distance between shapes
+		{
+			glm::vec2 min1, max1, min2, max2;
+			m_bodies.Bounds(body1, min1, max1);
+			m_bodies.Bounds(body2, min2, max2);
+
+			const glm::vec2 separation = glm::max(min2 - max1, min1 - max2);
+			gap = glm::max(separation.x, separation.y);
+		}
+
+		const float closingSpeed = (m_bodies.IsAwake(body1) ? glm::length(m_bodies.velocities[body1]) : 0.0f) +
+			(m_bodies.IsAwake(body2) ? glm::length(m_bodies.velocities[body2]) : 0.0f);
+
+		ticks = glm::min(ticks, FindIdleTicks(gap, closingSpeed));
+	}
+
+	return ticks;
+}
+
+
+unsigned int GameWorld::FindIdleTicks(float gap, float closingSpeed) const
+{
+	if (gap <= k_leapMargin) { return 0; }
+	if (closingSpeed <= 0.0f) { return UINT_MAX; }
+
+	//last tick before the contact is left to the fixed step, which resolves it
+	const float ticks = floorf((gap - k_leapMargin) / (closingSpeed * deltaTime)) - 1.0f;
+
+	return (ticks > 0.0f) ? static_cast<unsigned int>(glm::min(ticks, 1e6f)) : 0;
+}
+
+
+void GameWorld::Leap(unsigned int ticks)
+{
+	{
+		ProfileScope scope(Profiler::UPDATE_PUCK);
+		if (!m_puck->IsEnabled()) { m_puckRespawnDelay -= deltaTime * static_cast<float>(ticks); }
+	}
+
+	{
+		ProfileScope scope(Profiler::UPDATE_PLAYERS);
+		m_player1->SkipIdleTicks(ticks);
+		m_player2->SkipIdleTicks(ticks);
+	}
+
+	{
+		ProfileScope scope(Profiler::UPDATE_ENTITIES);
+		m_bodies.Integrate(deltaTime, ticks);
+	}
+
+	{
+		ProfileScope scope(Profiler::UPDATE_PHYSICS);
+
+		//back to bounds of a single tick, bodies that fell asleep during the leap keep them
+		for (size_t i = 0; i < m_bodies.GetCount(); i++)
+		{
+			if (!m_bodies.IsEnabled(i)) { continue; }
+
+			glm::vec2 min, max;
+			m_bodies.SweptBounds(i, deltaTime, min, max);
+			m_broadphase.Update(i, min, max);
+		}
+	}
+
+	m_ticks += ticks;
+}
+
+
+void GameWorld::DispatchCollisionEvents()
+{
+	//listeners may disable or move bodies, physics of the step is over by now
+	for (const CollisionEvent& event : m_collisionEvents)
+	{
+		Entity& entity = m_entities[event.body1];
+
+		switch (event.kind)
+		{
+			case CollisionEvent::BEGIN: entity.BeginCollision(m_entities[event.body2]); break;
+			case CollisionEvent::PERSIST: entity.PersistCollision(m_entities[event.body2]); break;
+			case CollisionEvent::END: entity.EndCollision(m_entities[event.body2]); break;
+			case CollisionEvent::WALL_BEGIN: entity.BeginCollision(Entity::WALL_LAYER); break;
+			case CollisionEvent::WALL_PERSIST: entity.PersistCollision(Entity::WALL_LAYER); break;
+			case CollisionEvent::WALL_END: entity.EndCollision(Entity::WALL_LAYER); break;
+		}
+	}
+
+	m_collisionEvents = CollisionEventList(m_collisionEvents.get_allocator()); //gives its buffer back before the arena is reset
+
+	FreeDespawnedEntities();
+}
+
+
+void GameWorld::FreeDespawnedEntities()
+{
+	for (const EntityHandle handle : m_despawnedEntities)
+	{
+		//listeners may have started an animation after the despawn
+		if (m_animatedIndices[handle.index] != k_noIndex) { SwapRemove(m_animatedEntities, m_animatedIndices, handle.index); }
+
+		m_entities.Erase(handle);
+	}
+
+	m_despawnedEntities.clear();
+}
+
+
+bool GameWorld::IsPuckSpawnerFree() const
+{
+	for (size_t i = 0; i < k_playgroundEntityCount; i++) //arena pucks are pushed away by the puck
+	{
+		if (!m_entities[i].IsEnabled()) { continue; }
+
+		if (m_entities[i].Contact(m_puckSpawner).isHit) { return false; }
+	}
+
+	return true;
+}
+
+
+void GameWorld::OnPlayerScore(Entity* gate, Entity* puck)
+{
+	gate->Play("Score");
+
+	m_puck->SetAnchoredPosition(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, 0.5f));
+	m_puck->SetVelocity(glm::vec2(0.0f, 0.0f));
+	m_puck->SetEnabled(false);
+
+	m_puckRespawnDelay = k_puckRespawnDelay;
+}
+
+
+void GameWorld::OnStickCollision(Entity* entity1, Entity* entity2)
+{
+	if (entity2 == m_puck)
+	{
+		entity1->PlayIfNotPlaying("Blink");
+	}
+}
+
+
+void GameWorld::OnPuckCollision(Entity* entity, Entity::mask_t layerMask)
+{
+	m_onPuckCollision.Invoke(layerMask);
+}
\ No newline at end of file
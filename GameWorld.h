@@ -0,0 +1,178 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <SDL.h>
+
+#include <glm/glm.hpp>
+
+#include "BodyStore.h"
+#include "BorderSet.h"
+#include "Broadphase.h"
+#include "ContactCache.h"
+#include "Controller.h"
+#include "Entity.h"
+#include "Event.h"
+#include "FrameArena.h"
+#include "Narrowphase.h"
+#include "SlotMap.h"
+
+
+// simulation state of a single match; worlds are independent from each other
+// and from the window, so many of them can be stepped on different threads
+
+
+class GameWorld
+{
+public:
+	struct MatchResult
+	{
+		unsigned int score1, score2;
+		unsigned long long ticks;
+	};
+
+	using EntityHandle = SlotMap<Entity>::Handle;
+
+	float deltaTime; //seconds; fixed physics step
+	float reverseWindowRatio; //playground height in playground widths
+
+	Event<void()> m_onNextRound;
+	Event<void(Entity::mask_t layerMask)> m_onPuckCollision;
+	Event<void(unsigned int player)> m_onScore;
+
+	//contact that began, persisted or ended during the step, listeners hear of it after the step
+	struct CollisionEvent
+	{
+		enum Kind : Uint8 { BEGIN, PERSIST, END, WALL_BEGIN, WALL_PERSIST, WALL_END }; //in the order of contact cache phases
+
+		BodyStore::handle_t body1, body2; //second one is the border index for walls
+		Kind kind;
+		manifold contact; //seen from the first body; the last one for ended contacts
+	};
+
+	//entity capacity below what the playground and arena pucks take is raised to it
+	GameWorld(float deltaTime, float reverseWindowRatio, unsigned int seed, unsigned int arenaPuckCount = 0, unsigned int entityCapacity = 0);
+	GameWorld(const GameWorld& other) = delete;
+	GameWorld& operator= (const GameWorld& other) = delete;
+
+	void Restart();
+	void Step();
+	unsigned int StepToNextEvent(); //skips ticks without contacts and control forces in closed form; returns ticks advanced
+	void Animate(float elapsedTime); //presentation only, headless matches never call it
+	void StartAnimating(BodyStore::handle_t entity); //entity is animated until its animation stops changing
+
+	//entity is set up by the caller; its layer never changes. Despawned entities are disabled at once
+	//and their slots reused after the next step, playground entities are never despawned
+	Entity& SpawnEntity(Entity::mask_t layerMask, Entity::mask_t collisionMask);
+	Entity& SpawnArenaPuck(const glm::vec2& position); //of the size the arena was filled with
+	void DespawnEntity(EntityHandle handle);
+
+	bool IsMatchFinished(unsigned int scoreLimit) const;
+	MatchResult GetResult() const;
+
+	Uint64 GetStateChecksum() const; //positions and velocities of all entities plus score
+	Uint32 GetDecisionChecksum() const; //move directions chosen by both players on the last step
+
+	inline unsigned int GetSeed() const { return m_seed; }
+	inline unsigned int Random() { return static_cast<unsigned int>(m_random()); } //the only randomness source of a match
+
+	void SetAutopilot(bool enabled);
+	void SetPhysicsThreadCount(unsigned int threadCount); //0 means hardware concurrency; results don't depend on it
+	inline bool IsAutopilot() const { return m_player1 != &m_player; }
+
+	inline KeyboardController& GetKeyboardController() { return m_player; }
+	inline SlotMap<Entity>& GetEntities() { return m_entities; }
+	inline Entity* GetEntity(EntityHandle handle) { return m_entities.Get(handle); } //null once despawned
+	inline EntityHandle GetEntityHandle(const Entity& entity) const { return m_entities.GetHandle(entity.GetBody()); }
+	inline BodyStore& GetBodies() { return m_bodies; }
+	inline const std::vector<line>& GetBorders() const { return m_borders; }
+	inline const BorderSet& GetBorderSet() const { return m_borderSet; }
+	inline const FrameArena& GetStepArena() const { return m_stepArena; }
+	inline const Narrowphase& GetNarrowphase() const { return m_narrowphase; }
+	inline const ContactCache& GetWallContacts() const { return m_wallContacts; }
+	inline unsigned int GetScore1() const { return m_score1; }
+	inline unsigned int GetScore2() const { return m_score2; }
+	inline unsigned long long GetTicks() const { return m_ticks; }
+
+	inline Entity* GetStick1() const { return m_stick1; }
+	inline Entity* GetStick2() const { return m_stick2; }
+	inline Entity* GetPuck() const { return m_puck; }
+	inline Entity* GetGate1() const { return m_gate1; }
+	inline Entity* GetGate2() const { return m_gate2; }
+	inline const std::vector<Entity*>& GetArenaPucks() const { return m_arenaPucks; }
+
+private:
+	using CollisionEventList = std::vector<CollisionEvent, FrameAllocator<CollisionEvent>>;
+
+	const unsigned int m_seed;
+	std::mt19937 m_random; //declared before controllers, they draw from it on construction
+
+	KeyboardController m_player;
+	AIController m_bot;
+	AIController m_bot2;
+
+	Controller *m_player1, *m_player2;
+	unsigned int m_score1, m_score2;
+	unsigned long long m_ticks; //since match start
+	float m_puckRespawnDelay;
+	unsigned int m_leapCooldown; //ticks stepped one by one before idle ticks are searched again
+
+	BodyStore m_bodies; //declared before entities, they add their bodies on construction
+	SlotMap<Entity> m_entities; //body handle of an entity equals its slot index
+	std::vector<EntityHandle> m_despawnedEntities; //freed after the events of the step are dispatched
+	std::vector<BodyStore::handle_t> m_animatedEntities; //only these are visited by Animate
+	std::vector<Uint32> m_animatedIndices; //by entity, its place in m_animatedEntities if it is there
+	std::vector<line> m_borders;
+	BorderSet m_borderSet; //same segments, laid out for the batch test
+
+	Entity *m_stick1, *m_stick2, *m_puck, *m_gate1, *m_gate2;
+	std::vector<Entity*> m_arenaPucks; //stress test only, they bounce around and never score
+	std::vector<Uint32> m_arenaPuckIndices; //by entity, its place in m_arenaPucks if it is one
+	float m_arenaPuckRadius;
+
+	std::vector<BodyStore::handle_t> m_layerBodies[Entity::LAYER_COUNT]; //spawned bodies, in no order
+	std::vector<Uint32> m_layerIndices; //by body, its place in the list of its layer until it is despawned
+
+	Broadphase m_broadphase; //proxy of an entity has the entity index; borders are tested by m_borderSet
+	Narrowphase m_narrowphase;
+	std::unique_ptr<ThreadPool> m_physicsPool; //islands of colliding bodies are solved there, none for a single thread
+	ContactCache m_wallContacts; //keyed by body and border index
+
+	FrameArena m_stepArena; //transient data of a step, reset when the next one starts
+	CollisionEventList m_collisionEvents; //of the current step, pairs by bodies, then walls by body and border
+
+	circle m_puckSpawner;
+
+	void InitPlayground();
+	void InitWalls();
+	void InitArena(unsigned int puckCount);
+
+	Entity* CreateStick();
+	Entity* CreatePuck();
+	Entity* CreateGate();
+	Entity* CreateArenaPuck();
+
+	void ScatterArenaPucks();
+
+	void UpdatePuck();
+	void UpdatePlayers();
+	void UpdatePhysics();
+	void UpdateWalls();
+	void CollideWithWalls(BodyStore::handle_t body);
+	void CollideWithWall(BodyStore::handle_t body, size_t border);
+	void UpdateEntities();
+	void DispatchCollisionEvents();
+	void FreeDespawnedEntities();
+
+	unsigned int FindIdleTicks(); //nothing collides and no controller pushes during them; moves broadphase bounds
+	unsigned int FindIdleTicks(float gap, float closingSpeed) const;
+	void Leap(unsigned int ticks);
+
+	bool IsPuckSpawnerFree() const;
+
+	void OnPlayerScore(Entity* gate, Entity* puck);
+	void OnStickCollision(Entity* entity1, Entity* entity2);
+	void OnPuckCollision(Entity* entity, Entity::mask_t layerMask);
+};
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "Gjk.h"
+
+
+constexpr float Gjk::k_epsilon;
+constexpr float Gjk::k_tolerance;
+
+
+void Gjk::Solve2(Vertex* simplex, int& count)
+{
+	const glm::vec2& w1 = simplex[0].point;
+	const glm::vec2& w2 = simplex[1].point;
+	const glm::vec2 edge = w2 - w1;
+
+	//region of w1
+	const float weight2 = -glm::dot(w1, edge);
+	if (weight2 <= 0.0f)
+	{
+		simplex[0].weight = 1.0f;
+		count = 1;
+		return;
+	}
+
+	//region of w2
+	const float weight1 = glm::dot(w2, edge);
+	if (weight1 <= 0.0f)
+	{
+		simplex[0] = simplex[1];
+		simplex[0].weight = 1.0f;
+		count = 1;
+		return;
+	}
+
+	const float inverse = 1.0f / (weight1 + weight2);
+	simplex[0].weight = weight1 * inverse;
+	simplex[1].weight = weight2 * inverse;
+	count = 2;
+}
+
+
+void Gjk::Solve3(Vertex* simplex, int& count)
+{
+	const glm::vec2 w1 = simplex[0].point;
+	const glm::vec2 w2 = simplex[1].point;
+	const glm::vec2 w3 = simplex[2].point;
+
+	//barycentric weights of the origin projected onto every edge
+	const glm::vec2 edge12 = w2 - w1;
+	const float weight12_1 = glm::dot(w2, edge12);
+	const float weight12_2 = -glm::dot(w1, edge12);
+
+	const glm::vec2 edge13 = w3 - w1;
+	const float weight13_1 = glm::dot(w3, edge13);
+	const float weight13_2 = -glm::dot(w1, edge13);
+
+	const glm::vec2 edge23 = w3 - w2;
+	const float weight23_1 = glm::dot(w3, edge23);
+	const float weight23_2 = -glm::dot(w2, edge23);
+
+	//and onto the triangle
+	const float area = Cross(edge12, edge13);
+	const float weight123_1 = area * Cross(w2, w3);
+	const float weight123_2 = area * Cross(w3, w1);
+	const float weight123_3 = area * Cross(w1, w2);
+
+	if (weight12_2 <= 0.0f && weight13_2 <= 0.0f)
+	{
+		simplex[0].weight = 1.0f;
+		count = 1;
+		return;
+	}
+
+	if (weight12_1 > 0.0f && weight12_2 > 0.0f && weight123_3 <= 0.0f)
+	{
+		const float inverse = 1.0f / (weight12_1 + weight12_2);
+		simplex[0].weight = weight12_1 * inverse;
+		simplex[1].weight = weight12_2 * inverse;
+		count = 2;
+		return;
+	}
+
+	if (weight13_1 > 0.0f && weight13_2 > 0.0f && weight123_2 <= 0.0f)
+	{
+		const float inverse = 1.0f / (weight13_1 + weight13_2);
+		simplex[0].weight = weight13_1 * inverse;
+		simplex[1] = simplex[2];
+		simplex[1].weight = weight13_2 * inverse;
+		count = 2;
+		return;
+	}
+
+	if (weight12_1 <= 0.0f && weight23_2 <= 0.0f)
+	{
+		simplex[0] = simplex[1];
+		simplex[0].weight = 1.0f;
+		count = 1;
+		return;
+	}
+
+	if (weight13_1 <= 0.0f && weight23_1 <= 0.0f)
+	{
+		simplex[0] = simplex[2];
+		simplex[0].weight = 1.0f;
+		count = 1;
+		return;
+	}
+
+	if (weight23_1 > 0.0f && weight23_2 > 0.0f && weight123_1 <= 0.0f)
+	{
+		const float inverse = 1.0f / (weight23_1 + weight23_2);
+		simplex[0] = simplex[2];
+		simplex[0].weight = weight23_2 * inverse;
+		simplex[1].weight = weight23_1 * inverse;
+		count = 2;
+		return;
+	}
+
+	//origin inside, the cores overlap
+	const float inverse = 1.0f / (weight123_1 + weight123_2 + weight123_3);
+	simplex[0].weight = weight123_1 * inverse;
+	simplex[1].weight = weight123_2 * inverse;
+	simplex[2].weight = weight123_3 * inverse;
+	count = 3;
+}
+
+
+glm::vec2 Gjk::SearchDirection(const Vertex* simplex, int count)
+{
+	if (count == 1) { return -simplex[0].point; }
+
+	//perpendicular of the edge is more precise than the negated closest point
+	const glm::vec2 edge = simplex[1].point - simplex[0].point;
+	return (Cross(edge, -simplex[0].point) > 0.0f) ? glm::vec2(-edge.y, edge.x) : glm::vec2(edge.y, -edge.x);
+}
+
+
+void Gjk::Witness(const Vertex* simplex, int count, glm::vec2& point1, glm::vec2& point2)
+{
+	point1 = point2 = glm::vec2(0.0f, 0.0f);
+
+	for (int i = 0; i < count; i++)
+	{
+		point1 += simplex[i].point1 * simplex[i].weight;
+		point2 += simplex[i].point2 * simplex[i].weight;
+	}
+}
+
+
+bool Gjk::IsDegenerate(const Vertex* simplex, int count)
+{
+	switch (count)
+	{
+		case 2:
+		{
+			const glm::vec2 edge = simplex[1].point - simplex[0].point;
+			return glm::dot(edge, edge) <= k_epsilon;
+		}
+
+		case 3: return glm::abs(Cross(simplex[1].point - simplex[0].point, simplex[2].point - simplex[0].point)) <= k_epsilon;
+
+		default: return count < 1 || count > 3;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Manifold.h"
+
+
+// general convex queries over support mappings: GJK finds the closest points of
+// the cores, margins are added on top; EPA takes over when the cores overlap.
+// Any shape with Support(direction), Vertex(index) and Margin() works
+
+
+class Gjk //static
+{
+public:
+	//support vertices the last query on a pair ended with, the next one starts from them
+	struct Simplex
+	{
+		int count;
+		int indices1[3], indices2[3];
+		int iterations; //support evaluations of the query that produced it
+
+		inline Simplex() : count(0), iterations(0) {}
+	};
+
+	template <typename type1, typename type2> static manifold Contact(const type1& shape1, const type2& shape2, Simplex* cache = nullptr);
+
+	//conservative advancement along displacement, shape2 is static
+	template <typename type1, typename type2> static manifold Sweep(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Simplex* cache = nullptr);
+
+private:
+	struct Vertex
+	{
+		glm::vec2 point1, point2; //on the cores of the shapes
+		glm::vec2 point; //point1 - point2, on the minkowski difference
+		float weight; //barycentric, of the point closest to the origin
+		int index1, index2;
+	};
+
+	static const int k_maxIterations = 20;
+	static const int k_maxPolytope = 32;
+	static constexpr float k_epsilon = 1e-12f; //squared lengths below are zero
+	static constexpr float k_tolerance = 1e-5f; //of distances, in field units
+
+	//reduces the simplex to the features closest to the origin; 3 vertices left means the cores overlap
+	template <typename type1, typename type2> static int Closest(const type1& shape1, const glm::vec2& offset1, const type2& shape2, Simplex& cache, Vertex* simplex);
+	template <typename type1, typename type2> static Vertex MakeVertex(const type1& shape1, const glm::vec2& offset1, const type2& shape2, int index1, int index2);
+
+	//penetration of overlapping cores by expanding the simplex into a polytope
+	template <typename type1, typename type2> static manifold Penetration(const type1& shape1, const type2& shape2, Vertex* simplex, int count);
+
+	static void Solve2(Vertex* simplex, int& count);
+	static void Solve3(Vertex* simplex, int& count);
+	static glm::vec2 SearchDirection(const Vertex* simplex, int count);
+	static void Witness(const Vertex* simplex, int count, glm::vec2& point1, glm::vec2& point2);
+	static bool IsDegenerate(const Vertex* simplex, int count);
+
+	static inline float Cross(const glm::vec2& a, const glm::vec2& b) { return a.x * b.y - a.y * b.x; }
+};
+
+
+#include "Gjk.inl"
\ No newline at end of file
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cfloat>
+#include <utility>
+
+
+template <typename type1, typename type2>
+manifold Gjk::Contact(const type1& shape1, const type2& shape2, Simplex* cache)
+{
+	Simplex local;
+	Simplex& start = cache ? *cache : local;
+
+	Vertex simplex[3];
+	const int count = Closest(shape1, glm::vec2(0.0f, 0.0f), shape2, start, simplex);
+
+	glm::vec2 point1, point2;
+	Witness(simplex, count, point1, point2);
+
+	const glm::vec2 offset = point1 - point2;
+	const float distanceSquared = glm::dot(offset, offset);
+
+	if (count == 3 || distanceSquared <= k_epsilon) { return Penetration(shape1, shape2, simplex, count); }
+
+	const float margin = shape1.Margin() + shape2.Margin();
+	if (distanceSquared >= margin * margin) { return manifold(); }
+
+	const float distance = sqrtf(distanceSquared);
+	const glm::vec2 normal = offset / distance;
+
+	return manifold(0.0f, normal, margin - distance, point2 + normal * shape2.Margin());
+}
+
+
+template <typename type1, typename type2>
+manifold Gjk::Sweep(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Simplex* cache)
+{
+	Simplex local;
+	Simplex& start = cache ? *cache : local;
+
+	const float margin = shape1.Margin() + shape2.Margin();
+	Vertex simplex[3];
+	float time = 0.0f;
+
+	for (int iteration = 0; iteration < k_maxIterations; iteration++)
+	{
+		const int count = Closest(shape1, displacement * time, shape2, start, simplex);
+
+		glm::vec2 point1, point2;
+		Witness(simplex, count, point1, point2);
+
+		const glm::vec2 offset = point1 - point2;
+		const float distanceSquared = glm::dot(offset, offset);
+		const float distance = sqrtf(distanceSquared);
+
+		//advancement stops short of the surface, so only a start inside gets here
+		if (count == 3 || distanceSquared <= k_epsilon || (time == 0.0f && distance < margin))
+		{
+			return (time == 0.0f) ? Contact(shape1, shape2, &start) : manifold();
+		}
+
+		const glm::vec2 normal = offset / distance;
+		const float gap = distance - margin;
+		const float approach = -glm::dot(displacement, normal);
+
+		//distance of convex shapes is convex in time, it only grows once it stops shrinking
+		if (approach <= 0.0f) { return manifold(); }
+		if (gap <= 2.0f * k_tolerance) { return manifold(time, normal, 0.0f, point2 + normal * shape2.Margin()); }
+
+		time += (gap - k_tolerance) / approach;
+		if (time > 1.0f) { return manifold(); }
+	}
+
+	return manifold();
+}
+
+
+template <typename type1, typename type2>
+int Gjk::Closest(const type1& shape1, const glm::vec2& offset1, const type2& shape2, Simplex& cache, Vertex* simplex)
+{
+	//vertices of the last query are still near the closest features when the shapes moved a little
+	int count = cache.count;
+	for (int i = 0; i < count; i++)
+	{
+		simplex[i] = MakeVertex(shape1, offset1, shape2, cache.indices1[i], cache.indices2[i]);
+	}
+
+	if (IsDegenerate(simplex, count))
+	{
+		simplex[0] = MakeVertex(shape1, offset1, shape2, 0, 0);
+		count = 1;
+	}
+
+	cache.iterations = 0;
+
+	for (;;)
+	{
+		int indices1[3], indices2[3];
+		const int previousCount = count;
+		for (int i = 0; i < count; i++)
+		{
+			indices1[i] = simplex[i].index1;
+			indices2[i] = simplex[i].index2;
+		}
+
+		switch (count)
+		{
+			case 1: simplex[0].weight = 1.0f; break;
+			case 2: Solve2(simplex, count); break;
+			case 3: Solve3(simplex, count); break;
+		}
+
+		if (count == 3 || cache.iterations == k_maxIterations) { break; }
+
+		const glm::vec2 direction = SearchDirection(simplex, count);
+		if (glm::dot(direction, direction) <= k_epsilon) { break; } //origin on the simplex
+
+		const Vertex vertex = MakeVertex(shape1, offset1, shape2, shape1.Support(direction), shape2.Support(-direction));
+		cache.iterations++;
+
+		//no progress is possible once a support vertex repeats
+		bool isRepeated = false;
+		for (int i = 0; i < previousCount; i++)
+		{
+			isRepeated = isRepeated || (vertex.index1 == indices1[i] && vertex.index2 == indices2[i]);
+		}
+
+		if (isRepeated) { break; }
+
+		simplex[count++] = vertex;
+	}
+
+	cache.count = count;
+	for (int i = 0; i < count; i++)
+	{
+		cache.indices1[i] = simplex[i].index1;
+		cache.indices2[i] = simplex[i].index2;
+	}
+
+	return count;
+}
+
+
+template <typename type1, typename type2>
+Gjk::Vertex Gjk::MakeVertex(const type1& shape1, const glm::vec2& offset1, const type2& shape2, int index1, int index2)
+{
+	Vertex result;
+	result.point1 = shape1.Vertex(index1) + offset1;
+	result.point2 = shape2.Vertex(index2);
+	result.point = result.point1 - result.point2;
+	result.weight = 1.0f;
+	result.index1 = index1;
+	result.index2 = index2;
+
+	return result;
+}
+
+
+template <typename type1, typename type2>
+manifold Gjk::Penetration(const type1& shape1, const type2& shape2, Vertex* simplex, int count)
+{
+	const glm::vec2 origin(0.0f, 0.0f);
+	const float margin = shape1.Margin() + shape2.Margin();
+
+	Vertex polytope[k_maxPolytope];
+	int size = count;
+	for (int i = 0; i < count; i++)
+	{
+		polytope[i] = simplex[i];
+	}
+
+	//simplices of touching cores are blown up to a triangle first
+	const glm::vec2 k_directions[] = { glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, 1.0f), glm::vec2(-1.0f, 0.0f), glm::vec2(0.0f, -1.0f) };
+	for (int i = 0; i < 4 && size == 1; i++)
+	{
+		polytope[size] = MakeVertex(shape1, origin, shape2, shape1.Support(k_directions[i]), shape2.Support(-k_directions[i]));
+		size += IsDegenerate(polytope, 2) ? 0 : 1;
+	}
+
+	for (int sign = 1; sign >= -1 && size == 2; sign -= 2)
+	{
+		const glm::vec2 side = polytope[1].point - polytope[0].point;
+		const glm::vec2 direction = glm::vec2(-side.y, side.x) * static_cast<float>(sign);
+		polytope[size] = MakeVertex(shape1, origin, shape2, shape1.Support(direction), shape2.Support(-direction));
+		size += IsDegenerate(polytope, 3) ? 0 : 1;
+	}
+
+	if (size < 3)
+	{
+		//flat minkowski difference, like collinear segments; pushed apart sideways
+		const glm::vec2 side = (size == 2) ? polytope[1].point - polytope[0].point : glm::vec2(1.0f, 0.0f);
+		const glm::vec2 normal = glm::normalize(glm::vec2(-side.y, side.x));
+		return manifold(0.0f, normal, margin, polytope[0].point2 + normal * shape2.Margin());
+	}
+
+	if (Cross(polytope[1].point - polytope[0].point, polytope[2].point - polytope[0].point) < 0.0f)
+	{
+		std::swap(polytope[1], polytope[2]); //counterclockwise
+	}
+
+	int edge = 0;
+	float distance = 0.0f;
+	glm::vec2 normal(0.0f, 0.0f);
+
+	for (int iteration = 0; ; iteration++)
+	{
+		distance = FLT_MAX;
+
+		for (int i = 0; i < size; i++)
+		{
+			const glm::vec2 side = polytope[(i + 1) % size].point - polytope[i].point;
+			const float lengthSquared = glm::dot(side, side);
+			if (lengthSquared <= k_epsilon) { continue; }
+
+			const glm::vec2 outward = glm::vec2(side.y, -side.x) / sqrtf(lengthSquared);
+			const float edgeDistance = glm::dot(outward, polytope[i].point);
+			if (edgeDistance < distance)
+			{
+				edge = i;
+				distance = edgeDistance;
+				normal = outward;
+			}
+		}
+
+		const Vertex vertex = MakeVertex(shape1, origin, shape2, shape1.Support(normal), shape2.Support(-normal));
+		if (glm::dot(vertex.point, normal) - distance <= k_tolerance || size == k_maxPolytope || iteration == k_maxIterations) { break; }
+
+		for (int i = size; i > edge + 1; i--)
+		{
+			polytope[i] = polytope[i - 1];
+		}
+
+		polytope[edge + 1] = vertex;
+		size++;
+
+		//simplex vertices may lie inside the difference, those turn reflex once it grows around them
+		int inserted = edge + 1;
+		for (int i = 0; i < size; )
+		{
+			const glm::vec2& previous = polytope[(i + size - 1) % size].point;
+			const glm::vec2& next = polytope[(i + 1) % size].point;
+
+			if (size == 3 || i == inserted || Cross(polytope[i].point - previous, next - polytope[i].point) > 0.0f)
+			{
+				i++;
+				continue;
+			}
+
+			for (int j = i; j < size - 1; j++)
+			{
+				polytope[j] = polytope[j + 1];
+			}
+
+			size--;
+			inserted -= (i < inserted) ? 1 : 0;
+			i = 0;
+		}
+	}
+
+	//closest point of the edge to the origin gives the point on the core of shape2
+	const Vertex& vertex1 = polytope[edge];
+	const Vertex& vertex2 = polytope[(edge + 1) % size];
+	const glm::vec2 side = vertex2.point - vertex1.point;
+	const float fraction = glm::clamp(-glm::dot(vertex1.point, side) / glm::dot(side, side), 0.0f, 1.0f);
+	const glm::vec2 point2 = vertex1.point2 + (vertex2.point2 - vertex1.point2) * fraction;
+
+	//moving shape1 against the closest edge normal separates the cores
+	return manifold(0.0f, -normal, distance + margin, point2 - normal * shape2.Margin());
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "InputQueue.h"
+
+
+namespace
+{
+	const size_t k_initialCapacity = 256;
+}
+
+
+InputQueue::InputQueue() :
+	m_samples(k_initialCapacity),
+	m_first(0),
+	m_count(0),
+	m_dispatchedCount(0),
+	m_totalLatency(0.0),
+	m_maxLatency(0)
+{}
+
+
+void InputQueue::Push(const Sample& sample)
+{
+	if (m_count == m_samples.size())
+	{
+		std::vector<Sample> samples(m_samples.size() * 2);
+
+		for (size_t i = 0; i < m_count; i++)
+		{
+			samples[i] = m_samples[(m_first + i) % m_samples.size()];
+		}
+
+		m_samples.swap(samples);
+		m_first = 0;
+	}
+
+	m_samples[(m_first + m_count) % m_samples.size()] = sample;
+	m_count++;
+}
+
+
+void InputQueue::Dispatch(double moment, KeyHandler onKeyDown, KeyHandler onKeyUp)
+{
+	if (m_count == 0) { return; }
+
+	const Uint32 now = SDL_GetTicks();
+
+	while (m_count > 0)
+	{
+		const Sample sample = m_samples[m_first];
+
+		if (sample.timestamp > moment) { return; }
+
+		const Uint32 latency = (now > sample.timestamp) ? now - sample.timestamp : 0;
+
+		m_dispatchedCount++;
+		m_totalLatency += latency;
+		if (latency > m_maxLatency) { m_maxLatency = latency; }
+
+		m_first = (m_first + 1) % m_samples.size();
+		m_count--;
+
+		if (sample.isPressed)
+		{
+			onKeyDown(sample.code);
+		}
+		else
+		{
+			onKeyUp(sample.code);
+		}
+	}
+}
\ No newline at end of file
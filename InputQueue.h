@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include <SDL.h>
+
+
+// keyboard samples keep SDL timestamps (milliseconds) so they can be applied
+// at the physics step covering the moment they happened, not at frame start
+
+
+class InputQueue
+{
+public:
+	using KeyHandler = void(*)(SDL_Scancode code);
+
+	struct Sample
+	{
+		Uint32 timestamp;
+		SDL_Scancode code;
+		bool isPressed;
+	};
+
+	InputQueue();
+
+	void Push(const Sample& sample);
+
+	//applies samples which happened before the moment, in order they happened
+	void Dispatch(double moment, KeyHandler onKeyDown, KeyHandler onKeyUp);
+
+	inline bool IsEmpty() const { return m_count == 0; }
+	inline unsigned long long GetDispatchedCount() const { return m_dispatchedCount; }
+	inline double GetAverageLatency() const { return m_dispatchedCount > 0 ? m_totalLatency / m_dispatchedCount : 0.0; }
+	inline Uint32 GetMaxLatency() const { return m_maxLatency; }
+
+private:
+	std::vector<Sample> m_samples; //ring buffer
+	size_t m_first;
+	size_t m_count;
+
+	unsigned long long m_dispatchedCount;
+	double m_totalLatency; //milliseconds between sample timestamp and its dispatch
+	Uint32 m_maxLatency;
+};
\ No newline at end of file
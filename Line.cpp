@@ -16,72 +16,42 @@ line::line(const glm::vec2& point1, const glm::vec2& point2) :
 {}
 
 
-float line::Contact(const line& other) const
+manifold line::Contact(const line& other) const
 {
-	const float k_errorCoefficient = 1.001f;
+	const glm::vec2 direction = point2 - point1;
+	const glm::vec2 otherDirection = other.point2 - other.point1;
+	const glm::vec2 offset = other.point1 - point1;
 
-	const glm::vec2 left = glm::normalize(other.point1 - point1);
-	const glm::vec2 right = glm::normalize(other.point2 - point1);
-	const glm::vec2 middle = glm::normalize(point2 - point1);
+	const float denominator = direction.x * otherDirection.y - direction.y * otherDirection.x;
+	if (denominator == 0.0f) { return manifold(); } //parallel segments are never reported
 
-	const float leftCosinus = glm::abs(glm::dot(left, middle));
-	const float rightCosinus = glm::abs(glm::dot(right, middle));
-	const float commonCosinus = glm::abs(glm::dot(left, right)) * k_errorCoefficient;
+	const float fraction = (offset.x * otherDirection.y - offset.y * otherDirection.x) / denominator;
+	const float otherFraction = (offset.x * direction.y - offset.y * direction.x) / denominator;
 
-	return (leftCosinus <= commonCosinus) && (rightCosinus <= commonCosinus);
-}
-
-
-float line::Contact(const circle& other) const
-{
-	const glm::vec2 distance1 = other.position - point1;
-	if (glm::dot(distance1, distance1) <= other.radius * other.radius) { return true; }
-
-	const glm::vec2 distance2 = other.position - point2;
-	if (glm::dot(distance2, distance2) <= other.radius * other.radius) { return true; }
+	if (fraction < 0.0f || fraction > 1.0f || otherFraction < 0.0f || otherFraction > 1.0f) { return manifold(); }
 
-	const glm::vec2 lineDirection = glm::normalize(point2 - point1);
-	const glm::vec2 projectionDirection = lineDirection * glm::dot(lineDirection, distance1) - (distance1);
+	//segments cross, so the normal of the other one only tells the side where this one starts
+	glm::vec2 normal = glm::normalize(glm::vec2(-otherDirection.y, otherDirection.x));
+	if (glm::dot(point1 - other.point1, normal) < 0.0f) { normal = -normal; }
 
-	if (glm::length(projectionDirection) > other.radius) { return false; }
-
-	const float dotprod1 = glm::dot(distance1, lineDirection);
-	const float dotprod2 = glm::dot(distance2, -lineDirection);
-
-	return (dotprod1 >= 0.0f) && (dotprod2 >= 0.0f);
+	return manifold(0.0f, normal, 0.0f, point1 + direction * fraction);
 }
 
 
-float line::Contact(const rectangle& other) const
+manifold line::Contact(const circle& other) const
 {
-	assert(false);
-	return false; //TODO
+	return other.Contact(*this).Flipped();
 }
 
 
 glm::vec2 line::Nearest(const glm::vec2& from) const
 {
-	const glm::vec2 distance1 = from - point1;
-	const glm::vec2 distance2 = from - point2;
-	const glm::vec2 lineDirection = glm::normalize(point2 - point1);
-
-	const float dotprod1 = glm::dot(distance1, lineDirection);
-	const float dotprod2 = glm::dot(distance2, -lineDirection);
-
-	if ((dotprod1 >= 0.0f) && (dotprod2 >= 0.0f))
-	{
-		const glm::vec2 projectionPoint = point1 + lineDirection * glm::dot(lineDirection, distance1);
-		return projectionPoint;
-	}
-	else
-	{
-		if (glm::length(distance1) < glm::length(distance2))
-		{
-			return point1;
-		}
-		else
-		{
-			return point2;
-		}
-	}
+	const glm::vec2 direction = point2 - point1;
+	const float squaredLength = glm::dot(direction, direction);
+
+	if (squaredLength <= 0.0f) { return point1; }
+
+	const float projection = glm::clamp(glm::dot(from - point1, direction) / squaredLength, 0.0f, 1.0f);
+
+	return point1 + direction * projection;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include "Manifold.h"
+
 
 struct line;
 struct circle;
@@ -15,11 +17,15 @@ struct line final
 	line();
 	line(const glm::vec2& point1, const glm::vec2& point2);
 
-	float Contact(const line& other) const;
-	float Contact(const circle& other) const;
-	float Contact(const rectangle& other) const;
+	manifold Contact(const line& other) const;
+	manifold Contact(const circle& other) const;
 
 	inline float length() const { return glm::length(point1 - point2); }
 
+	//support mapping for general convex queries, the segment has no margin
+	inline int Support(const glm::vec2& direction) const { return (glm::dot(point2 - point1, direction) > 0.0f) ? 1 : 0; }
+	inline glm::vec2 Vertex(int index) const { return (index == 0) ? point1 : point2; }
+	inline float Margin() const { return 0.0f; }
+
 	glm::vec2 Nearest(const glm::vec2& from) const;
 };
\ No newline at end of file
@@ -3,13 +3,35 @@
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 
+#include "Benchmark.h"
 #include "Game.h"
+#include "Replay.h"
+#include "Settings.h"
 
 
-void main()
+int main(int argc, char* argv[])
 {
-	if (Game::Init())
+	Settings settings;
+
+	if (!settings.Parse(argc, argv)) { return 1; }
+
+	if (settings.isBenchmark)
+	{
+		return Benchmark::Run(settings) ? 0 : 1;
+	}
+
+	if (!settings.replayFile.empty())
 	{
+		return Replay::Play(settings) ? 0 : 1;
+	}
+
+	if (Game::Init(settings))
+	{
+		if (Game::IsHeadless())
+		{
+			Game::RunMatches();
+		}
+
 		while (!Game::IsEnded())
 		{
 			Game::StartFrame();
@@ -20,5 +42,5 @@ void main()
 		}
 	}
 
-	Game::Exit();
+	return Game::Exit() ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+
+// contact of two shapes as found by the narrowphase, either by a static test
+// or by sweeping one shape along a displacement; response code uses it as is
+
+
+struct manifold final
+{
+	bool isHit;
+	float time; //fraction of the displacement travelled before the touch, [0; 1]; zero for static tests
+	float depth; //overlap along the normal, nonzero only if shapes already overlapped before moving
+	glm::vec2 normal; //unit, from the other shape towards this one
+	glm::vec2 point; //where the shapes touch, on the surface of the other shape
+
+	inline manifold() :
+		isHit(false),
+		time(1.0f),
+		depth(0.0f),
+		normal(0.0f, 0.0f),
+		point(0.0f, 0.0f)
+	{}
+
+	inline manifold(float time, const glm::vec2& normal, float depth, const glm::vec2& point) :
+		isHit(true),
+		time(time),
+		depth(depth),
+		normal(normal),
+		point(point)
+	{}
+
+	inline bool IsEarlierThan(const manifold& other) const { return isHit && (!other.isHit || time < other.time); }
+
+	//same contact seen from the other shape
+	inline manifold Flipped() const
+	{
+		manifold result = *this;
+		result.normal = -normal;
+		result.point = point - normal * depth;
+		return result;
+	}
+};
\ No newline at end of file
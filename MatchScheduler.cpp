@@ -0,0 +1,80 @@
+#include "MatchScheduler.h"
+
+#include "AllocationTracker.h"
+#include "ThreadPool.h"
+
+
+MatchScheduler::MatchScheduler(const Settings& settings, float reverseWindowRatio) :
+	m_settings(settings),
+	m_reverseWindowRatio(reverseWindowRatio),
+	m_threadCount(0),
+	m_results(settings.matchCount)
+{}
+
+
+void MatchScheduler::Run()
+{
+	ThreadPool pool(m_settings.threadCount);
+
+	m_threadCount = pool.GetThreadCount();
+
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		pool.Submit([this, i]() { m_results[i] = RunMatch(i); });
+	}
+
+	pool.Wait();
+
+	if (!m_settings.recordFile.empty())
+	{
+		m_replay.Save(m_settings.recordFile);
+	}
+}
+
+
+unsigned long long MatchScheduler::GetTotalTicks() const
+{
+	unsigned long long ticks = 0;
+
+	for (const GameWorld::MatchResult& result : m_results)
+	{
+		ticks += result.ticks;
+	}
+
+	return ticks;
+}
+
+
+GameWorld::MatchResult MatchScheduler::RunMatch(size_t index)
+{
+	GameWorld world(1.0f / m_settings.physicsRate, m_reverseWindowRatio, m_settings.seed + static_cast<unsigned int>(index), m_settings.arenaPuckCount, m_settings.entityCapacity);
+
+	world.SetAutopilot(true);
+	world.SetPhysicsThreadCount(m_settings.physicsThreadCount);
+	world.Restart();
+
+	if (index == 0 && !m_settings.recordFile.empty())
+	{
+		m_replay.Begin(world);
+
+		while (!world.IsMatchFinished(m_settings.scoreLimit))
+		{
+			m_replay.Step(world);
+		}
+
+		return world.GetResult();
+	}
+
+	const unsigned long long warmupTicks = static_cast<unsigned long long>(AllocationTracker::k_warmupDuration * m_settings.physicsRate);
+
+	while (!world.IsMatchFinished(m_settings.scoreLimit))
+	{
+		if (m_settings.isEventDriven) { world.StepToNextEvent(); } else { world.Step(); }
+
+		if (world.GetTicks() >= warmupTicks) { AllocationTracker::SetStrict(m_settings.isAllocationTest); }
+	}
+
+	AllocationTracker::SetStrict(false); //pool thread takes the next match from warm-up again
+
+	return world.GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "GameWorld.h"
+#include "Replay.h"
+#include "Settings.h"
+
+
+// runs headless matches, one world per thread pool task
+
+
+class MatchScheduler
+{
+public:
+	MatchScheduler(const Settings& settings, float reverseWindowRatio);
+
+	void Run();
+
+	inline const std::vector<GameWorld::MatchResult>& GetResults() const { return m_results; }
+	inline unsigned int GetThreadCount() const { return m_threadCount; }
+	unsigned long long GetTotalTicks() const;
+
+private:
+	const Settings m_settings;
+	const float m_reverseWindowRatio;
+	unsigned int m_threadCount;
+
+	std::vector<GameWorld::MatchResult> m_results;
+	Replay m_replay; //of the first match
+
+	GameWorld::MatchResult RunMatch(size_t index);
+};
\ No newline at end of file
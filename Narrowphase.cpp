@@ -0,0 +1,167 @@
+#include "Narrowphase.h"
+
+
+const Uint32 Narrowphase::k_noIsland;
+
+
+namespace
+{
+	const Uint32 k_minBatchPairs = 64; //fewer pairs don't pay off a task
+	const unsigned int k_batchesPerThread = 4; //tasks are stolen by idle workers, more of them even out the load
+}
+
+
+Narrowphase::Narrowphase() :
+	m_islandCount(0)
+{}
+
+
+void Narrowphase::Reserve(size_t bodyCount, size_t pairCount)
+{
+	//every bucket may hold all pairs, islands are at most one per body
+	for (int type1 = 0; type1 < shape::TYPE_COUNT; type1++)
+	{
+		for (int type2 = 0; type2 < shape::TYPE_COUNT; type2++)
+		{
+			m_buckets[type1][type2].reserve(pairCount);
+			m_islandStarts[type1][type2].reserve(bodyCount + 1);
+		}
+	}
+
+	m_parents.reserve(bodyCount);
+	m_islands.reserve(bodyCount);
+	m_sortedPairs.reserve(pairCount);
+	m_cursors.reserve(bodyCount);
+	m_islandPairCounts.reserve(bodyCount);
+
+	m_contacts.Reserve(pairCount);
+}
+
+
+void Narrowphase::Sort(const std::vector<Broadphase::Pair>& pairs, const BodyStore& bodies)
+{
+	for (std::vector<Broadphase::Pair>* bucket = &m_buckets[0][0]; bucket != &m_buckets[0][0] + shape::TYPE_COUNT * shape::TYPE_COUNT; bucket++)
+	{
+		bucket->clear();
+	}
+
+	m_parents.resize(bodies.GetCount());
+
+	for (Uint32 i = 0; i < m_parents.size(); i++)
+	{
+		m_parents[i] = i;
+	}
+
+	for (const Broadphase::Pair& pair : pairs)
+	{
+		const shape::Type type1 = bodies.shapeTypes[pair.key1];
+		const shape::Type type2 = bodies.shapeTypes[pair.key2];
+
+		m_buckets[type1][type2].push_back(pair);
+
+		//responses never write to static bodies, so they don't link islands
+		if (bodies.IsStatic(pair.key1) || bodies.IsStatic(pair.key2)) { continue; }
+
+		const Uint32 root1 = FindRoot(pair.key1);
+		const Uint32 root2 = FindRoot(pair.key2);
+
+		if (root1 != root2) { m_parents[glm::max(root1, root2)] = glm::min(root1, root2); }
+	}
+
+	m_islands.assign(bodies.GetCount(), k_noIsland);
+	m_islandCount = 0;
+
+	for (size_t bucket = 0; bucket < shape::TYPE_COUNT * shape::TYPE_COUNT; bucket++)
+	{
+		for (const Broadphase::Pair& pair : (&m_buckets[0][0])[bucket])
+		{
+			const Uint32 root = FindRoot(bodies.IsStatic(pair.key1) ? pair.key2 : pair.key1);
+
+			if (m_islands[root] == k_noIsland) { m_islands[root] = static_cast<Uint32>(m_islandCount++); }
+		}
+	}
+
+	for (size_t bucket = 0; bucket < shape::TYPE_COUNT * shape::TYPE_COUNT; bucket++)
+	{
+		SortByIsland((&m_buckets[0][0])[bucket], (&m_islandStarts[0][0])[bucket], bodies);
+	}
+}
+
+
+Uint32 Narrowphase::FindRoot(Uint32 body)
+{
+	while (m_parents[body] != body)
+	{
+		m_parents[body] = m_parents[m_parents[body]]; //path halving
+		body = m_parents[body];
+	}
+
+	return body;
+}
+
+
+void Narrowphase::SortByIsland(std::vector<Broadphase::Pair>& bucket, std::vector<Uint32>& islandStarts, const BodyStore& bodies)
+{
+	islandStarts.clear();
+	if (bucket.empty()) { return; }
+
+	//counting sort, stable, so pairs of an island keep the order a single pass would run them in
+	islandStarts.assign(m_islandCount + 1, 0);
+
+	for (const Broadphase::Pair& pair : bucket)
+	{
+		islandStarts[m_islands[FindRoot(bodies.IsStatic(pair.key1) ? pair.key2 : pair.key1)] + 1]++;
+	}
+
+	for (size_t i = 1; i < islandStarts.size(); i++)
+	{
+		islandStarts[i] += islandStarts[i - 1];
+	}
+
+	m_cursors.assign(islandStarts.begin(), islandStarts.end() - 1);
+	m_sortedPairs.resize(bucket.size());
+
+	for (const Broadphase::Pair& pair : bucket)
+	{
+		m_sortedPairs[m_cursors[m_islands[FindRoot(bodies.IsStatic(pair.key1) ? pair.key2 : pair.key1)]]++] = pair;
+	}
+
+	bucket.swap(m_sortedPairs);
+}
+
+
+void Narrowphase::Batch(unsigned int threadCount)
+{
+	m_islandPairCounts.assign(m_islandCount, 0);
+
+	for (size_t bucket = 0; bucket < shape::TYPE_COUNT * shape::TYPE_COUNT; bucket++)
+	{
+		const std::vector<Uint32>& starts = (&m_islandStarts[0][0])[bucket];
+
+		for (Uint32 island = 0; island + 1 < starts.size(); island++)
+		{
+			m_islandPairCounts[island] += starts[island + 1] - starts[island];
+		}
+	}
+
+	Uint32 totalPairCount = 0;
+
+	for (const Uint32 count : m_islandPairCounts) { totalPairCount += count; }
+
+	const Uint32 batchPairCount = glm::max(k_minBatchPairs, totalPairCount / (threadCount * k_batchesPerThread));
+	Uint32 batchPairs = 0;
+
+	m_batchStarts.clear();
+
+	for (Uint32 island = 0; island < m_islandCount; island++)
+	{
+		if (batchPairs == 0) { m_batchStarts.push_back(island); }
+
+		batchPairs += m_islandPairCounts[island];
+		if (batchPairs >= batchPairCount) { batchPairs = 0; }
+	}
+
+	m_batchStarts.push_back(static_cast<Uint32>(m_islandCount));
+
+	if (m_batchEntries.size() < m_batchStarts.size() - 1) { m_batchEntries.resize(m_batchStarts.size() - 1); }
+}
\ No newline at end of file
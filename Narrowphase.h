@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include "BodyStore.h"
+#include "Broadphase.h"
+#include "ContactCache.h"
+#include "Shape.h"
+#include "ThreadPool.h"
+
+
+// broadphase pairs are bucketed by the shape types of their bodies, then every
+// bucket is swept by a kernel compiled for exactly that combination of shapes;
+// contacts are cached by pair, so pairs at rest skip the test and pairs on the
+// general convex path warm start from their last simplex.
+// Bodies linked by pairs form islands. Resolving a contact writes only to the
+// bodies of its pair, so islands are independent: they run on a thread pool,
+// every one in the order a single thread would run its pairs, and results don't
+// depend on it. Contacts that began, persisted or ended are reported after all islands
+
+
+class Narrowphase
+{
+public:
+	Narrowphase();
+
+	void Reserve(size_t bodyCount, size_t pairCount); //pairs of all buckets together
+
+	//keys of pairs are body handles; layers of pairs are expected to collide
+	void Sort(const std::vector<Broadphase::Pair>& pairs, const BodyStore& bodies);
+
+	//resolve(body1, body2, contact) for every pair touching within the step, on pool threads if given;
+	//then report(body1, body2, contact, phase) on the calling thread for every contact that began or persisted
+	//and with the last contact of every pair that stopped touching, ordered by bodies
+	template <typename Resolve, typename Report> void Run(const BodyStore& bodies, float deltaTime, Resolve resolve, Report report, ThreadPool* pool = nullptr);
+
+	inline size_t GetPairCount(shape::Type type1, shape::Type type2) const { return m_buckets[type1][type2].size(); }
+	inline size_t GetIslandCount() const { return m_islandCount; }
+	inline const ContactCache& GetContacts() const { return m_contacts; }
+
+private:
+	static const Uint32 k_noIsland = 0xFFFFFFFF;
+
+	std::vector<Broadphase::Pair> m_buckets[shape::TYPE_COUNT][shape::TYPE_COUNT]; //by island, then in broadphase order
+	std::vector<Uint32> m_islandStarts[shape::TYPE_COUNT][shape::TYPE_COUNT]; //first pair of every island in the bucket, then the end
+	ContactCache m_contacts;
+
+	std::vector<Uint32> m_parents; //union find over bodies
+	std::vector<Uint32> m_islands; //by root body
+	size_t m_islandCount;
+	std::vector<Broadphase::Pair> m_sortedPairs; //scratch of the sort by island
+	std::vector<Uint32> m_cursors; //same
+
+	std::vector<Uint32> m_islandPairCounts;
+	std::vector<Uint32> m_batchStarts; //first island of every pool task, then the end
+	std::vector<std::vector<ContactCache::Entry>> m_batchEntries; //tracked by the tasks, added to the cache after them
+
+	//raised by removing either body, so a pair of reused handles never takes over contacts of the removed ones
+	inline static Uint32 GetGeneration(const BodyStore& bodies, Uint32 key1, Uint32 key2) { return bodies.generations[key1] + bodies.generations[key2]; }
+
+	Uint32 FindRoot(Uint32 body);
+	void SortByIsland(std::vector<Broadphase::Pair>& bucket, std::vector<Uint32>& islandStarts, const BodyStore& bodies);
+	void Batch(unsigned int threadCount); //islands into tasks of similar pair counts
+
+	//entries are tracked into the cache itself when null
+	template <typename Resolve> void RunIsland(Uint32 island, const BodyStore& bodies, float deltaTime, Resolve& resolve, std::vector<ContactCache::Entry>* entries);
+	template <typename type1, typename Resolve> void RunRow(Uint32 island, const BodyStore& bodies, float deltaTime, Resolve& resolve, std::vector<ContactCache::Entry>* entries);
+	template <typename type1, typename type2, typename Resolve> void RunBucket(Uint32 island, const BodyStore& bodies, float deltaTime, Resolve& resolve, std::vector<ContactCache::Entry>* entries);
+};
+
+
+#include "Narrowphase.inl"
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+
+template <typename Resolve, typename Report>
+void Narrowphase::Run(const BodyStore& bodies, float deltaTime, Resolve resolve, Report report, ThreadPool* pool)
+{
+	m_contacts.Begin();
+
+	if (!pool || pool->GetThreadCount() < 2)
+	{
+		for (Uint32 island = 0; island < m_islandCount; island++)
+		{
+			RunIsland(island, bodies, deltaTime, resolve, nullptr);
+		}
+	}
+	else
+	{
+		Batch(pool->GetThreadCount());
+
+		const auto runBatch = [this, &bodies, deltaTime, &resolve](size_t batch)
+		{
+			std::vector<ContactCache::Entry>& entries = m_batchEntries[batch];
+			entries.clear();
+
+			for (Uint32 island = m_batchStarts[batch]; island < m_batchStarts[batch + 1]; island++)
+			{
+				RunIsland(island, bodies, deltaTime, resolve, &entries);
+			}
+		};
+
+		//tasks capture two words, they fit into the inline storage of the task function without a heap allocation
+		for (size_t batch = 0; batch + 1 < m_batchStarts.size(); batch++)
+		{
+			pool->Submit([&runBatch, batch]() { runBatch(batch); });
+		}
+
+		pool->Wait();
+
+		for (size_t batch = 0; batch + 1 < m_batchStarts.size(); batch++)
+		{
+			m_contacts.Add(m_batchEntries[batch]);
+		}
+	}
+
+	m_contacts.End([&bodies](Uint32 key1, Uint32 key2) { return GetGeneration(bodies, key1, key2); },
+		[&report](const ContactCache::Entry& entry, ContactCache::Phase phase) { report(entry.key1, entry.key2, entry.contact, phase); });
+}
+
+
+template <typename Resolve>
+void Narrowphase::RunIsland(Uint32 island, const BodyStore& bodies, float deltaTime, Resolve& resolve, std::vector<ContactCache::Entry>* entries)
+{
+	RunRow<circle>(island, bodies, deltaTime, resolve, entries);
+	RunRow<rectangle>(island, bodies, deltaTime, resolve, entries);
+	RunRow<line>(island, bodies, deltaTime, resolve, entries);
+	RunRow<convex>(island, bodies, deltaTime, resolve, entries);
+}
+
+
+template <typename type1, typename Resolve>
+void Narrowphase::RunRow(Uint32 island, const BodyStore& bodies, float deltaTime, Resolve& resolve, std::vector<ContactCache::Entry>* entries)
+{
+	RunBucket<type1, circle>(island, bodies, deltaTime, resolve, entries);
+	RunBucket<type1, rectangle>(island, bodies, deltaTime, resolve, entries);
+	RunBucket<type1, line>(island, bodies, deltaTime, resolve, entries);
+	RunBucket<type1, convex>(island, bodies, deltaTime, resolve, entries);
+}
+
+
+template <typename type1, typename type2, typename Resolve>
+void Narrowphase::RunBucket(Uint32 island, const BodyStore& bodies, float deltaTime, Resolve& resolve, std::vector<ContactCache::Entry>* entries)
+{
+	const std::vector<Broadphase::Pair>& pairs = m_buckets[shape::TypeOf<type1>()][shape::TypeOf<type2>()];
+	const std::vector<Uint32>& starts = m_islandStarts[shape::TypeOf<type1>()][shape::TypeOf<type2>()];
+
+	if (starts.empty()) { return; }
+
+	const bool isGeneral = !shape::IsSpecialized(shape::TypeOf<type1>(), shape::TypeOf<type2>());
+
+	for (Uint32 i = starts[island]; i < starts[island + 1]; i++)
+	{
+		const Broadphase::Pair& pair = pairs[i];
+
+		const glm::vec2 offset = bodies.positions[pair.key1] - bodies.positions[pair.key2];
+		const glm::vec2 displacement = (bodies.velocities[pair.key1] - bodies.velocities[pair.key2]) * deltaTime;
+		const Uint32 generation = GetGeneration(bodies, pair.key1, pair.key2);
+		ContactCache::Entry& entry = entries ?
+			m_contacts.Track(*entries, pair.key1, pair.key2, generation, offset, displacement, bodies.positions[pair.key2]) :
+			m_contacts.Track(pair.key1, pair.key2, generation, offset, displacement, bodies.positions[pair.key2]);
+
+		//neither body of a resting pair can move, its contact carries over until one of them wakes up
+		if (!bodies.IsAwake(pair.key1) && !bodies.IsAwake(pair.key2)) { continue; }
+
+		if (!entry.isRevalidated)
+		{
+			entry.contact = shape::SweepPair(bodies.GetShape<type1>(pair.key1), displacement, bodies.GetShape<type2>(pair.key2), isGeneral ? &entry.simplex : nullptr);
+		}
+
+		if (entry.contact.isHit) { resolve(pair.key1, pair.key2, entry.contact); }
+	}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+const size_t Profiler::k_capacity;
+
+bool Profiler::s_isEnabled = false;
+Profiler::Ring Profiler::s_rings[PHASE_COUNT];
+thread_local Profiler::Phase Profiler::t_currentPhase = Profiler::PHASE_COUNT;
+
+
+void Profiler::Record(Phase phase, Uint64 duration)
+{
+	Ring& ring = s_rings[phase];
+
+	const Uint64 index = ring.writeIndex.fetch_add(1, std::memory_order_relaxed);
+
+	ring.samples[index & (k_capacity - 1)].store(duration, std::memory_order_relaxed);
+}
+
+
+Profiler::Statistics Profiler::GetStatistics(Phase phase)
+{
+	Statistics result = { 0.0, 0.0, 0.0, 0.0, 0 };
+
+	Uint64 samples[k_capacity];
+	const size_t count = Snapshot(phase, samples);
+
+	if (count == 0) { return result; }
+
+	const double millisecondsPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+
+	const auto percentile = [&](double ratio)
+	{
+		const size_t index = std::min(static_cast<size_t>(ratio * count), count - 1);
+		std::nth_element(samples, samples + index, samples + count);
+		return samples[index] * millisecondsPerTick;
+	};
+
+	result.p50 = percentile(0.50);
+	result.p95 = percentile(0.95);
+	result.p99 = percentile(0.99);
+	result.max = *std::max_element(samples, samples + count) * millisecondsPerTick;
+	result.count = count;
+
+	return result;
+}
+
+
+const char* Profiler::GetPhaseName(Phase phase)
+{
+	switch (phase)
+	{
+		case START_FRAME: return "StartFrame";
+		case PROCESS_EVENTS: return "ProcessEvents";
+		case UPDATE_PUCK: return "UpdatePuck";
+		case UPDATE_PLAYERS: return "UpdatePlayers";
+		case UPDATE_PHYSICS: return "UpdatePhysics";
+		case UPDATE_ENTITIES: return "UpdateEntities";
+		case DISPATCH_EVENTS: return "DispatchEvents";
+		case RENDER_ENTITIES: return "RenderEntities";
+		case RENDER_BORDERS: return "RenderBorders";
+		case RENDER_SCORE: return "RenderScore";
+		case RENDER_PRESENT: return "RenderPresent";
+		default: return "Unknown";
+	}
+}
+
+
+bool Profiler::DumpCsv(const std::string& file)
+{
+	std::ofstream stream(file);
+
+	if (!stream)
+	{
+		std::cerr << "Failed to open profile file " << file << "\n";
+		return false;
+	}
+
+	const double millisecondsPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+
+	std::vector<Uint64> samples(k_capacity);
+
+	stream << "phase,sample,milliseconds\n";
+
+	for (int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		const size_t count = Snapshot(static_cast<Phase>(phase), samples.data());
+
+		for (size_t i = 0; i < count; i++)
+		{
+			stream << GetPhaseName(static_cast<Phase>(phase)) << "," << i << "," << samples[i] * millisecondsPerTick << "\n";
+		}
+	}
+
+	return true;
+}
+
+
+size_t Profiler::Snapshot(Phase phase, Uint64* samples)
+{
+	const Ring& ring = s_rings[phase];
+
+	const Uint64 written = ring.writeIndex.load(std::memory_order_relaxed);
+	const size_t count = static_cast<size_t>(std::min<Uint64>(written, k_capacity));
+	const Uint64 first = written - count; //oldest sample still in the ring
+
+	for (size_t i = 0; i < count; i++)
+	{
+		samples[i] = ring.samples[(first + i) & (k_capacity - 1)].load(std::memory_order_relaxed);
+	}
+
+	return count;
+}
\ No newline at end of file
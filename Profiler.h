@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include <SDL.h>
+
+
+// every phase keeps its last samples in a lock-free ring buffer; writers only
+// bump an atomic index, so scopes can be used from the simulation threads too
+
+
+class Profiler //static
+{
+public:
+	enum Phase : unsigned char
+	{
+		START_FRAME,
+		PROCESS_EVENTS,
+		UPDATE_PUCK,
+		UPDATE_PLAYERS,
+		UPDATE_PHYSICS,
+		UPDATE_ENTITIES,
+		DISPATCH_EVENTS,
+		RENDER_ENTITIES,
+		RENDER_BORDERS,
+		RENDER_SCORE,
+		RENDER_PRESENT,
+		PHASE_COUNT
+	};
+
+	struct Statistics //milliseconds
+	{
+		double p50, p95, p99, max;
+		size_t count;
+	};
+
+	static const size_t k_capacity = 1024; //samples per phase, power of two
+
+	inline static bool IsEnabled() { return s_isEnabled; }
+	inline static void SetEnabled(bool enabled) { s_isEnabled = enabled; }
+
+	static void Record(Phase phase, Uint64 duration); //performance counter ticks
+
+	//innermost scope open on the calling thread, PHASE_COUNT outside of all; kept whether enabled or not
+	inline static Phase GetCurrentPhase() { return t_currentPhase; }
+	inline static Phase EnterPhase(Phase phase) { const Phase previous = t_currentPhase; t_currentPhase = phase; return previous; }
+	inline static void LeavePhase(Phase previous) { t_currentPhase = previous; }
+
+	static Statistics GetStatistics(Phase phase);
+	static const char* GetPhaseName(Phase phase);
+
+	static bool DumpCsv(const std::string& file);
+
+private:
+	struct Ring
+	{
+		std::atomic<Uint64> writeIndex;
+		std::atomic<Uint64> samples[k_capacity];
+	};
+
+	static bool s_isEnabled;
+	static Ring s_rings[PHASE_COUNT];
+	static thread_local Phase t_currentPhase;
+
+	static size_t Snapshot(Phase phase, Uint64* samples);
+};
+
+
+class ProfileScope final
+{
+public:
+	inline explicit ProfileScope(Profiler::Phase phase) :
+		m_phase(phase),
+		m_previousPhase(Profiler::EnterPhase(phase)),
+		m_start(Profiler::IsEnabled() ? SDL_GetPerformanceCounter() : 0)
+	{}
+
+	inline ~ProfileScope()
+	{
+		if (m_start != 0) { Profiler::Record(m_phase, SDL_GetPerformanceCounter() - m_start); }
+
+		Profiler::LeavePhase(m_previousPhase);
+	}
+
+	ProfileScope(const ProfileScope& other) = delete;
+	ProfileScope& operator= (const ProfileScope& other) = delete;
+
+private:
+	const Profiler::Phase m_phase;
+	const Profiler::Phase m_previousPhase;
+	const Uint64 m_start;
+};
\ No newline at end of file
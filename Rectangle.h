@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include "Manifold.h"
+
 
 struct line;
 struct circle;
@@ -11,21 +13,32 @@ struct rectangle;
 struct rectangle final
 {
 	glm::vec2 position;
-	glm::vec2 axis1, axis2;
+	glm::vec2 direction1, direction2; //unit axes, cached so queries don't normalize
+	glm::vec2 halfSize; //along direction1 and direction2
 
 	rectangle();
-	rectangle(const glm::vec2& position, const glm::vec2& size);
-	rectangle(const glm::vec2& position, const glm::vec2& axis1, const glm::vec2& axis2);
+	rectangle(const glm::vec2& position, const glm::vec2& size); //axis aligned
+	rectangle(const glm::vec2& position, const glm::vec2& axis1, const glm::vec2& axis2); //axes are half extents
+
+	inline glm::vec2 Axis1() const { return direction1 * halfSize.x; }
+	inline glm::vec2 Axis2() const { return direction2 * halfSize.y; }
+
+	inline glm::vec2 ToLocal(const glm::vec2& point) const { return glm::vec2(glm::dot(point - position, direction1), glm::dot(point - position, direction2)); }
+	inline glm::vec2 ToWorld(const glm::vec2& local) const { return position + direction1 * local.x + direction2 * local.y; }
 
 	bool Contain(const glm::vec2& point) const;
 
-	float Contact(const line& other) const;
-	float Contact(const circle& other) const;
-	float Contact(const rectangle& other) const;
+	//support mapping for general convex queries, corners are indexed by the signs of the axes
+	inline int Support(const glm::vec2& direction) const { return ((glm::dot(direction, direction1) < 0.0f) ? 1 : 0) | ((glm::dot(direction, direction2) < 0.0f) ? 2 : 0); }
+	inline glm::vec2 Vertex(int index) const { return position + Axis1() * ((index & 1) ? -1.0f : 1.0f) + Axis2() * ((index & 2) ? -1.0f : 1.0f); }
+	inline float Margin() const { return 0.0f; }
+
+	manifold Contact(const circle& other) const;
+	manifold Contact(const rectangle& other) const;
 
 	float Radius() const;
 	circle BoundingCircle() const;
-	glm::vec2 Nearest(const glm::vec2& from) const;
+	glm::vec2 Nearest(const glm::vec2& from) const; //points inside are returned as they are
 
 	void Resize(const glm::vec2& size);
 };
\ No newline at end of file
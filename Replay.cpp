@@ -0,0 +1,181 @@
+#include "Replay.h"
+
+#include <fstream>
+#include <iostream>
+
+
+namespace
+{
+	const char k_magic[4] = { 'A', 'H', 'R', 'P' };
+	const Uint32 k_version = 2;
+
+
+	template<typename T>
+	inline void Write(std::ofstream& stream, const T& value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template<typename T>
+	inline bool Read(std::ifstream& stream, T& value)
+	{
+		return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+}
+
+
+Replay::Replay() :
+	m_seed(0),
+	m_deltaTime(0.0f),
+	m_reverseWindowRatio(0.0f),
+	m_arenaPuckCount(0),
+	m_pendingFlags(0)
+{}
+
+
+void Replay::Begin(const GameWorld& world)
+{
+	m_seed = world.GetSeed();
+	m_deltaTime = world.deltaTime;
+	m_reverseWindowRatio = world.reverseWindowRatio;
+	m_arenaPuckCount = static_cast<Uint32>(world.GetArenaPucks().size());
+
+	m_ticks.clear();
+	m_pendingFlags = 0;
+}
+
+
+void Replay::Step(GameWorld& world)
+{
+	Tick tick;
+	tick.keyState = world.GetKeyboardController().GetKeyState();
+	tick.flags = m_pendingFlags | (world.IsAutopilot() ? AUTOPILOT_FLAG : 0);
+
+	world.Step();
+
+	tick.decisions = world.GetDecisionChecksum();
+	tick.checksum = world.GetStateChecksum();
+
+	m_ticks.push_back(tick);
+	m_pendingFlags = 0;
+}
+
+
+void Replay::MarkRestart()
+{
+	m_pendingFlags |= RESTART_FLAG;
+}
+
+
+bool Replay::Save(const std::string& file) const
+{
+	std::ofstream stream(file, std::ios::binary);
+
+	if (!stream)
+	{
+		std::cerr << "Failed to write replay " << file << "\n";
+		return false;
+	}
+
+	stream.write(k_magic, sizeof(k_magic));
+	Write(stream, k_version);
+	Write(stream, m_seed);
+	Write(stream, m_deltaTime);
+	Write(stream, m_reverseWindowRatio);
+	Write(stream, m_arenaPuckCount);
+	Write(stream, static_cast<Uint64>(m_ticks.size()));
+
+	for (const Tick& tick : m_ticks)
+	{
+		Write(stream, tick.keyState);
+		Write(stream, tick.flags);
+		Write(stream, tick.decisions);
+		Write(stream, tick.checksum);
+	}
+
+	return static_cast<bool>(stream);
+}
+
+
+bool Replay::Load(const std::string& file)
+{
+	std::ifstream stream(file, std::ios::binary);
+
+	if (!stream)
+	{
+		std::cerr << "Failed to read replay " << file << "\n";
+		return false;
+	}
+
+	char magic[sizeof(k_magic)];
+	Uint32 version;
+	Uint64 count;
+
+	const bool isHeaderRead = stream.read(magic, sizeof(magic)) && Read(stream, version) && Read(stream, m_seed) && Read(stream, m_deltaTime) && Read(stream, m_reverseWindowRatio) && Read(stream, m_arenaPuckCount) && Read(stream, count);
+
+	if (!isHeaderRead || std::char_traits<char>::compare(magic, k_magic, sizeof(k_magic)) != 0 || version != k_version)
+	{
+		std::cerr << "Replay " << file << " has unknown format\n";
+		return false;
+	}
+
+	m_ticks.resize(static_cast<size_t>(count));
+
+	for (Tick& tick : m_ticks)
+	{
+		if (!Read(stream, tick.keyState) || !Read(stream, tick.flags) || !Read(stream, tick.decisions) || !Read(stream, tick.checksum))
+		{
+			std::cerr << "Replay " << file << " is truncated\n";
+			return false;
+		}
+	}
+
+	m_pendingFlags = 0;
+
+	return true;
+}
+
+
+bool Replay::Play(const Settings& settings)
+{
+	Replay replay;
+
+	if (!replay.Load(settings.replayFile)) { return false; }
+
+	GameWorld world(replay.m_deltaTime, replay.m_reverseWindowRatio, replay.m_seed, replay.m_arenaPuckCount, settings.entityCapacity);
+	world.SetPhysicsThreadCount(settings.physicsThreadCount); //islands give the same results on any thread count
+	world.Restart();
+
+	const Uint64 startCounter = SDL_GetPerformanceCounter();
+
+	for (size_t i = 0; i < replay.m_ticks.size(); i++)
+	{
+		const Tick& tick = replay.m_ticks[i];
+
+		if (tick.flags & RESTART_FLAG) { world.Restart(); }
+
+		world.SetAutopilot((tick.flags & AUTOPILOT_FLAG) != 0);
+		world.GetKeyboardController().SetKeyState(tick.keyState);
+		world.Step();
+
+		const bool isDecisionDiverged = world.GetDecisionChecksum() != tick.decisions;
+		const bool isStateDiverged = world.GetStateChecksum() != tick.checksum;
+
+		if (isDecisionDiverged || isStateDiverged)
+		{
+			std::cerr << "Desync at tick " << i << " of " << replay.m_ticks.size() << " (match tick " << (world.GetTicks() - 1) << "): ";
+			std::cerr << (isStateDiverged ? "world state" : "player decisions") << " differs from the record\n";
+			return false;
+		}
+	}
+
+	const double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+	std::cout << "Replay of seed " << replay.m_seed << " matches the record: " << replay.m_ticks.size() << " ticks, score " << world.GetScore1() << " - " << world.GetScore2();
+
+	if (elapsed > 0.0) { std::cout << " (" << static_cast<Uint64>(replay.m_ticks.size() / elapsed) << " ticks/s)"; }
+
+	std::cout << "\n";
+
+	return true;
+}
\ No newline at end of file
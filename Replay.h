@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+#include "GameWorld.h"
+#include "Settings.h"
+
+
+// a match is recorded as the world seed plus per tick keyboard state; state
+// checksums stored along let a replay name the first tick where it diverged
+
+
+class Replay
+{
+public:
+	enum TickFlags : Uint8
+	{
+		RESTART_FLAG = 1 << 0, //world was restarted right before the step
+		AUTOPILOT_FLAG = 1 << 1
+	};
+
+	struct Tick
+	{
+		Uint8 keyState; //KeyboardController state the step was made with
+		Uint8 flags;
+		Uint32 decisions; //GameWorld::GetDecisionChecksum after the step
+		Uint64 checksum; //GameWorld::GetStateChecksum after the step
+	};
+
+	Replay();
+
+	void Begin(const GameWorld& world); //call right after the world is restarted
+	void Step(GameWorld& world); //steps the world and records the tick
+	void MarkRestart();
+
+	bool Save(const std::string& file) const;
+	bool Load(const std::string& file);
+
+	inline size_t GetTickCount() const { return m_ticks.size(); }
+
+	static bool Play(const Settings& settings); //false on desync or io failure
+
+private:
+	unsigned int m_seed;
+	float m_deltaTime;
+	float m_reverseWindowRatio;
+	Uint32 m_arenaPuckCount;
+
+	std::vector<Tick> m_ticks;
+	Uint8 m_pendingFlags;
+};
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "Settings.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+
+Settings::Settings() :
+	isHeadless(false),
+	physicsRate(240.0f),
+	matchCount(1),
+	scoreLimit(7),
+	threadCount(0),
+	physicsThreadCount(1),
+	arenaPuckCount(0),
+	entityCapacity(0),
+	isEventDriven(false),
+	isTrackingAllocations(false),
+	isAllocationTest(false),
+	seed(0),
+	isBenchmark(false)
+{}
+
+
+bool Settings::Parse(int argc, char* argv[])
+{
+	bool hasSeed = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* argument = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (strcmp(argument, "--headless") == 0)
+		{
+			isHeadless = true;
+		}
+		else if (strcmp(argument, "--physics-rate") == 0 && value)
+		{
+			physicsRate = static_cast<float>(atof(value));
+			i++;
+		}
+		else if (strcmp(argument, "--matches") == 0 && value)
+		{
+			matchCount = static_cast<unsigned int>(atoi(value));
+			i++;
+		}
+		else if (strcmp(argument, "--score-limit") == 0 && value)
+		{
+			scoreLimit = static_cast<unsigned int>(atoi(value));
+			i++;
+		}
+		else if (strcmp(argument, "--threads") == 0 && value)
+		{
+			threadCount = static_cast<unsigned int>(atoi(value));
+			i++;
+		}
+		else if (strcmp(argument, "--physics-threads") == 0 && value)
+		{
+			physicsThreadCount = static_cast<unsigned int>(atoi(value));
+			i++;
+		}
+		else if (strcmp(argument, "--pucks") == 0 && value)
+		{
+			arenaPuckCount = static_cast<unsigned int>(atoi(value));
+			i++;
+		}
+		else if (strcmp(argument, "--entities") == 0 && value)
+		{
+			entityCapacity = static_cast<unsigned int>(atoi(value));
+			i++;
+		}
+		else if (strcmp(argument, "--event-driven") == 0)
+		{
+			isEventDriven = true;
+		}
+		else if (strcmp(argument, "--profile-csv") == 0 && value)
+		{
+			profileFile = value;
+			i++;
+		}
+		else if (strcmp(argument, "--track-allocations") == 0)
+		{
+			isTrackingAllocations = true;
+		}
+		else if (strcmp(argument, "--allocation-test") == 0)
+		{
+			isTrackingAllocations = true;
+			isAllocationTest = true;
+		}
+		else if (strcmp(argument, "--seed") == 0 && value)
+		{
+			seed = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+			hasSeed = true;
+			i++;
+		}
+		else if (strcmp(argument, "--record") == 0 && value)
+		{
+			recordFile = value;
+			i++;
+		}
+		else if (strcmp(argument, "--replay") == 0 && value)
+		{
+			replayFile = value;
+			i++;
+		}
+		else if (strcmp(argument, "--benchmark") == 0)
+		{
+			isBenchmark = true;
+		}
+		else if (strcmp(argument, "--benchmark-output") == 0 && value)
+		{
+			benchmarkOutput = value;
+			i++;
+		}
+		else if (strcmp(argument, "--benchmark-baseline") == 0 && value)
+		{
+			benchmarkBaseline = value;
+			i++;
+		}
+		else
+		{
+			std::cerr << "Unknown argument " << argument << "\n";
+			std::cerr << "Usage: Airhockey [--headless] [--physics-rate HZ] [--matches N] [--score-limit N] [--threads N] [--physics-threads N]\n";
+			std::cerr << "                 [--profile-csv FILE] [--pucks N] [--entities N] [--event-driven] [--seed N] [--record FILE]\n";
+			std::cerr << "                 [--track-allocations] [--allocation-test (not with --record)]\n";
+			std::cerr << "       Airhockey --replay FILE [--physics-threads N] [--entities N]\n";
+			std::cerr << "       Airhockey --benchmark [--benchmark-output FILE] [--benchmark-baseline FILE]\n";
+			return false;
+		}
+	}
+
+	if (!hasSeed)
+	{
+		seed = std::random_device()();
+	}
+
+	if (physicsRate <= 0.0f)
+	{
+		std::cerr << "Physics rate must be positive\n";
+		return false;
+	}
+
+	if (matchCount == 0 || scoreLimit == 0)
+	{
+		std::cerr << "Match count and score limit must be positive\n";
+		return false;
+	}
+
+	if (isAllocationTest && !recordFile.empty())
+	{
+		std::cerr << "Allocation test can't be recorded, the input log grows every tick\n";
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+struct Settings
+{
+	bool isHeadless; //no window, renderer, audio or frame sleep; both sticks are controlled by AI
+	float physicsRate; //Hertz; physics runs with fixed step independently from frame rate
+	unsigned int matchCount; //headless only
+	unsigned int scoreLimit; //headless only; match ends when one of players reaches it
+	unsigned int threadCount; //headless only; 0 means hardware concurrency
+	unsigned int physicsThreadCount; //of every world, for islands of colliding bodies; 0 means hardware concurrency
+	unsigned int arenaPuckCount; //extra pucks bouncing around the playground, physics stress test
+	unsigned int entityCapacity; //of every world, room for spawned entities; never less than the playground and arena pucks take
+	bool isEventDriven; //headless only, not recorded matches; ticks without contacts and control forces are skipped, results differ from fixed step
+	std::string profileFile; //per phase frame timings are written there on exit if not empty
+	bool isTrackingAllocations; //heap allocations per phase and subsystem are reported on exit
+	bool isAllocationTest; //tracks allocations and fails on exit if any was made after warm-up; can't be recorded
+
+	unsigned int seed; //of the first match, following headless matches use next seeds; random if not given
+	std::string recordFile; //input log of the match is written there on exit; first match only when headless
+	std::string replayFile; //replay the log headlessly and verify every tick instead of running the game
+
+	bool isBenchmark; //run geometry and physics microbenchmarks instead of the game
+	std::string benchmarkOutput; //JSON report; printed to standard output if empty
+	std::string benchmarkBaseline; //JSON report of previous run to compare with
+
+	Settings();
+
+	bool Parse(int argc, char* argv[]);
+};
\ No newline at end of file
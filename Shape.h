@@ -1,36 +1,96 @@
 #pragma once
 
+#include <iostream>
+#include <type_traits>
+
+#include <SDL.h>
+
 #include "Line.h"
 #include "Circle.h"
 #include "Rectangle.h"
+#include "Convex.h"
+#include "Gjk.h"
 
 
 struct shape final
 {
-	enum Type : unsigned char { LINE, CIRCLE, RECTANGLE };
+	enum Type : unsigned char { LINE, CIRCLE, RECTANGLE, CONVEX, TYPE_COUNT };
 
 	union Data
 	{
 		line m_line;
 		circle m_circle;
 		rectangle m_rectangle;
+		convex m_convex;
 
 		inline Data() {}
 	};
 
+	static_assert(sizeof(Data) == sizeof(rectangle), "Hull vertices are kept out of line, rectangles set the size of all shapes");
+
 	Type m_type;
 	Data m_data;
 
 	shape();
 
-	float Contact(const shape& other) const;
+	manifold Contact(const shape& other) const;
+
+	template <typename type> manifold Contact(const type& other) const;
 
-	template <typename type> float Contact(const type& other) const;
+	manifold Sweep(const glm::vec2& displacement, const shape& other) const;
+
+	template <typename type> manifold Sweep(const glm::vec2& displacement, const type& other) const;
 
 	void Translate(const glm::vec2& distance);
+	void Bounds(glm::vec2& min, glm::vec2& max) const; //axis aligned
+
+	template <typename type> static constexpr Type TypeOf();
+	template <typename type> const type& Get() const; //data of the current type only
+
+	//pairs without a hand-written test fall back to the general convex queries
+	inline static constexpr bool IsSpecialized(Type type1, Type type2)
+	{
+		const bool k_specializedPairs[TYPE_COUNT][TYPE_COUNT] =
+		{
+			//LINE   CIRCLE  RECTANGLE  CONVEX
+			{ true,  true,   false,     false }, //LINE
+			{ true,  true,   true,      false }, //CIRCLE
+			{ false, true,   true,      false }, //RECTANGLE
+			{ false, false,  false,     false }, //CONVEX
+		};
+
+		return k_specializedPairs[type1][type2];
+	}
+
+	//typed narrowphase; general queries start from the cached simplex if given
+	template <typename type1, typename type2> static manifold ContactPair(const type1& shape1, const type2& shape2, Gjk::Simplex* cache = nullptr);
+	template <typename type1, typename type2> static manifold SweepPair(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Gjk::Simplex* cache = nullptr);
 
 private:
-	inline static constexpr unsigned char Combination(Type type1, Type type2) { return static_cast<unsigned char>((type1 << 4) | type2); }
+	template <typename type1, typename type2> using Specialized = std::integral_constant<bool, IsSpecialized(TypeOf<type1>(), TypeOf<type2>())>;
+
+	template <typename type1, typename type2> static manifold ContactSpecialized(const type1& shape1, const type2& shape2, Gjk::Simplex* cache, std::true_type);
+	template <typename type1, typename type2> static manifold ContactSpecialized(const type1& shape1, const type2& shape2, Gjk::Simplex* cache, std::false_type);
+	template <typename type1, typename type2> static manifold SweepSpecialized(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Gjk::Simplex* cache, std::true_type);
+	template <typename type1, typename type2> static manifold SweepSpecialized(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Gjk::Simplex* cache, std::false_type);
+
+	//only circles are swept exactly, the other shape is swept in reverse when it is the circle
+	template <typename type> static manifold SweepMoving(const circle& shape1, const glm::vec2& displacement, const type& shape2);
+	template <typename type> static manifold SweepMoving(const type& shape1, const glm::vec2& displacement, const circle& shape2);
+	static manifold SweepMoving(const circle& shape1, const glm::vec2& displacement, const circle& shape2);
+	template <typename type1, typename type2> static manifold SweepMoving(const type1& shape1, const glm::vec2& displacement, const type2& shape2);
+
+	static line Translated(const line& source, const glm::vec2& distance);
+	static rectangle Translated(const rectangle& source, const glm::vec2& distance);
+
+	template <typename type1, typename type2> static manifold ContactShapes(const shape& shape1, const shape& shape2);
+	template <typename type1, typename type2> static manifold SweepShapes(const shape& shape1, const glm::vec2& displacement, const shape& shape2);
+
+	using ContactFunction = manifold (*)(const shape&, const shape&);
+	using SweepFunction = manifold (*)(const shape&, const glm::vec2&, const shape&);
+
+	static const ContactFunction k_contactFunctions[TYPE_COUNT][TYPE_COUNT];
+	static const SweepFunction k_sweepFunctions[TYPE_COUNT][TYPE_COUNT];
 };
 
 
@@ -1,20 +1,158 @@
 #pragma once
 
 
+template <> constexpr shape::Type shape::TypeOf<line>() { return LINE; }
+template <> constexpr shape::Type shape::TypeOf<circle>() { return CIRCLE; }
+template <> constexpr shape::Type shape::TypeOf<rectangle>() { return RECTANGLE; }
+template <> constexpr shape::Type shape::TypeOf<convex>() { return CONVEX; }
+
+
+template <> inline const line& shape::Get<line>() const { SDL_assert(m_type == LINE); return m_data.m_line; }
+template <> inline const circle& shape::Get<circle>() const { SDL_assert(m_type == CIRCLE); return m_data.m_circle; }
+template <> inline const rectangle& shape::Get<rectangle>() const { SDL_assert(m_type == RECTANGLE); return m_data.m_rectangle; }
+template <> inline const convex& shape::Get<convex>() const { SDL_assert(m_type == CONVEX); return m_data.m_convex; }
+
+
+template <typename type>
+manifold shape::Contact(const type& other) const
+{
+	switch (m_type)
+	{
+		case Type::LINE: return ContactPair(m_data.m_line, other);
+		case Type::CIRCLE: return ContactPair(m_data.m_circle, other);
+		case Type::RECTANGLE: return ContactPair(m_data.m_rectangle, other);
+		case Type::CONVEX: return ContactPair(m_data.m_convex, other);
+
+		default:
+		{
+			SDL_assert(false);
+			std::cerr << "Unhandled shape combination";
+			return manifold();
+		}
+	}
+}
+
+
 template <typename type>
-float shape::Contact(const type& other) const
+manifold shape::Sweep(const glm::vec2& displacement, const type& other) const
 {
 	switch (m_type)
 	{
-		case Type::LINE: return m_data.m_line.Contact(other);
-		case Type::CIRCLE: return m_data.m_circle.Contact(other);
-		case Type::RECTANGLE: return m_data.m_rectangle.Contact(other);
+		case Type::LINE: return SweepPair(m_data.m_line, displacement, other);
+		case Type::CIRCLE: return SweepPair(m_data.m_circle, displacement, other);
+		case Type::RECTANGLE: return SweepPair(m_data.m_rectangle, displacement, other);
+		case Type::CONVEX: return SweepPair(m_data.m_convex, displacement, other);
 
 		default:
 		{
 			SDL_assert(false);
 			std::cerr << "Unhandled shape combination";
-			return 0.0f;
+			return manifold();
 		}
 	}
+}
+
+
+template <typename type1, typename type2>
+manifold shape::ContactPair(const type1& shape1, const type2& shape2, Gjk::Simplex* cache)
+{
+	return ContactSpecialized(shape1, shape2, cache, Specialized<type1, type2>());
+}
+
+
+template <typename type1, typename type2>
+manifold shape::SweepPair(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Gjk::Simplex* cache)
+{
+	return SweepSpecialized(shape1, displacement, shape2, cache, Specialized<type1, type2>());
+}
+
+
+template <typename type1, typename type2>
+manifold shape::ContactSpecialized(const type1& shape1, const type2& shape2, Gjk::Simplex*, std::true_type)
+{
+	return shape1.Contact(shape2);
+}
+
+
+template <typename type1, typename type2>
+manifold shape::ContactSpecialized(const type1& shape1, const type2& shape2, Gjk::Simplex* cache, std::false_type)
+{
+	return Gjk::Contact(shape1, shape2, cache);
+}
+
+
+template <typename type1, typename type2>
+manifold shape::SweepSpecialized(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Gjk::Simplex*, std::true_type)
+{
+	return SweepMoving(shape1, displacement, shape2);
+}
+
+
+template <typename type1, typename type2>
+manifold shape::SweepSpecialized(const type1& shape1, const glm::vec2& displacement, const type2& shape2, Gjk::Simplex* cache, std::false_type)
+{
+	return Gjk::Sweep(shape1, displacement, shape2, cache);
+}
+
+
+template <typename type>
+manifold shape::SweepMoving(const circle& shape1, const glm::vec2& displacement, const type& shape2)
+{
+	return shape1.Sweep(displacement, shape2);
+}
+
+
+template <typename type>
+manifold shape::SweepMoving(const type& shape1, const glm::vec2& displacement, const circle& shape2)
+{
+	return shape2.Sweep(-displacement, shape1).Flipped();
+}
+
+
+inline manifold shape::SweepMoving(const circle& shape1, const glm::vec2& displacement, const circle& shape2)
+{
+	return shape1.Sweep(displacement, shape2);
+}
+
+
+template <typename type1, typename type2>
+manifold shape::SweepMoving(const type1& shape1, const glm::vec2& displacement, const type2& shape2)
+{
+	//only circles move in this game; other shapes are checked at both ends of the displacement
+	const manifold overlap = shape1.Contact(shape2);
+	if (overlap.isHit) { return overlap; }
+
+	manifold result = Translated(shape1, displacement).Contact(shape2);
+	result.time = 1.0f;
+
+	return result;
+}
+
+
+inline line shape::Translated(const line& source, const glm::vec2& distance)
+{
+	return line(source.point1 + distance, source.point2 + distance);
+}
+
+
+inline rectangle shape::Translated(const rectangle& source, const glm::vec2& distance)
+{
+	rectangle result = source;
+	result.position += distance;
+
+	return result;
+}
+
+
+template <typename type1, typename type2>
+manifold shape::ContactShapes(const shape& shape1, const shape& shape2)
+{
+	return ContactPair(shape1.Get<type1>(), shape2.Get<type2>());
+}
+
+
+template <typename type1, typename type2>
+manifold shape::SweepShapes(const shape& shape1, const glm::vec2& displacement, const shape& shape2)
+{
+	return SweepPair(shape1.Get<type1>(), displacement, shape2.Get<type2>());
 }
\ No newline at end of file
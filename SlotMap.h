@@ -0,0 +1,100 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <SDL.h>
+
+
+// fixed capacity pool of objects that never move while alive, so pointers to them
+// stay valid; handles carry the generation of their slot and are safe to keep past
+// removal. Live objects are iterated densely, free slots are reused first
+
+
+template<typename T>
+class SlotMap
+{
+private:
+	using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+public:
+	struct Handle
+	{
+		Uint32 index;
+		Uint32 generation; //of the slot when the object was added
+
+		inline bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+		inline bool operator!=(const Handle& other) const { return !(*this == other); }
+	};
+
+	template<typename Value>
+	class Iterator
+	{
+	public:
+		Iterator(const Uint32* slot, Storage* values) : m_slot(slot), m_values(values) {}
+
+		inline Value& operator*() const { return *reinterpret_cast<Value*>(&m_values[*m_slot]); }
+		inline Value* operator->() const { return reinterpret_cast<Value*>(&m_values[*m_slot]); }
+		inline Iterator& operator++() { m_slot++; return *this; }
+		inline bool operator!=(const Iterator& other) const { return m_slot != other.m_slot; }
+
+	private:
+		const Uint32* m_slot;
+		Storage* m_values;
+	};
+
+	static const Uint32 k_noSlot = 0xFFFFFFFF;
+
+	SlotMap();
+	explicit SlotMap(size_t capacity);
+	~SlotMap();
+	SlotMap(const SlotMap& other) = delete;
+	SlotMap& operator= (const SlotMap& other) = delete;
+
+	void Reserve(size_t capacity); //storage is allocated once, while the map is empty
+
+	template<typename... Args> Handle Emplace(Args&&... args); //map must not be full
+	void Erase(Handle handle); //stale handles are ignored, so erasing twice is harmless
+
+	inline bool IsValid(Handle handle) const { return handle.index < m_usedSlotCount && m_slots[handle.index].generation == handle.generation && IsAlive(handle.index); }
+	inline bool IsAlive(Uint32 index) const { return m_slots[index].denseIndex != k_noSlot; }
+
+	inline T* Get(Handle handle) { return IsValid(handle) ? &(*this)[handle.index] : nullptr; }
+	inline const T* Get(Handle handle) const { return IsValid(handle) ? &(*this)[handle.index] : nullptr; }
+
+	//by slot index, the slot has to hold a live object
+	inline T& operator[](Uint32 index) { SDL_assert(IsAlive(index)); return *reinterpret_cast<T*>(&m_values[index]); }
+	inline const T& operator[](Uint32 index) const { SDL_assert(IsAlive(index)); return *reinterpret_cast<const T*>(&m_values[index]); }
+
+	inline Handle GetHandle(Uint32 index) const { return { index, m_slots[index].generation }; }
+	inline Uint32 GetNextIndex() const { return (m_firstFree != k_noSlot) ? m_firstFree : m_usedSlotCount; } //slot the next Emplace takes
+
+	inline size_t GetCount() const { return m_dense.size(); }
+	inline size_t GetCapacity() const { return m_capacity; }
+	inline bool IsFull() const { return m_dense.size() == m_capacity; }
+
+	//live objects, in the order they were added until some are erased
+	inline Iterator<T> begin() { return Iterator<T>(m_dense.data(), m_values.get()); }
+	inline Iterator<T> end() { return Iterator<T>(m_dense.data() + m_dense.size(), m_values.get()); }
+	inline Iterator<const T> begin() const { return Iterator<const T>(m_dense.data(), m_values.get()); }
+	inline Iterator<const T> end() const { return Iterator<const T>(m_dense.data() + m_dense.size(), m_values.get()); }
+
+private:
+	struct Slot
+	{
+		Uint32 generation; //bumped on removal, handles of earlier objects don't match anymore
+		Uint32 denseIndex; //k_noSlot in free slots
+		Uint32 nextFree;
+	};
+
+	std::unique_ptr<Storage[]> m_values;
+	std::unique_ptr<Slot[]> m_slots;
+	std::vector<Uint32> m_dense; //slots of live objects
+	size_t m_capacity;
+	Uint32 m_usedSlotCount; //slots past it were never taken
+	Uint32 m_firstFree;
+};
+
+
+#include "SlotMap.inl"
\ No newline at end of file
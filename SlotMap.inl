@@ -0,0 +1,97 @@
+#pragma once
+
+#include <new>
+#include <utility>
+
+
+template<typename T>
+const Uint32 SlotMap<T>::k_noSlot;
+
+
+template<typename T>
+SlotMap<T>::SlotMap() :
+	m_capacity(0),
+	m_usedSlotCount(0),
+	m_firstFree(k_noSlot)
+{}
+
+
+template<typename T>
+SlotMap<T>::SlotMap(size_t capacity) :
+	SlotMap()
+{
+	Reserve(capacity);
+}
+
+
+template<typename T>
+SlotMap<T>::~SlotMap()
+{
+	for (T& value : *this)
+	{
+		value.~T();
+	}
+}
+
+
+template<typename T>
+void SlotMap<T>::Reserve(size_t capacity)
+{
+	SDL_assert(m_dense.empty() && m_usedSlotCount == 0); //live objects would move
+	SDL_assert(capacity < k_noSlot);
+
+	m_values.reset(new Storage[capacity]);
+	m_slots.reset(new Slot[capacity]);
+	m_dense.reserve(capacity);
+	m_capacity = capacity;
+}
+
+
+template<typename T>
+template<typename... Args>
+typename SlotMap<T>::Handle SlotMap<T>::Emplace(Args&&... args)
+{
+	SDL_assert(!IsFull());
+
+	const Uint32 index = GetNextIndex();
+
+	if (index == m_firstFree)
+	{
+		m_firstFree = m_slots[index].nextFree;
+	}
+	else
+	{
+		m_slots[index] = { 0, k_noSlot, k_noSlot };
+		m_usedSlotCount++;
+	}
+
+	new (&m_values[index]) T(std::forward<Args>(args)...);
+
+	Slot& slot = m_slots[index];
+	slot.denseIndex = static_cast<Uint32>(m_dense.size());
+	m_dense.push_back(index);
+
+	return { index, slot.generation };
+}
+
+
+template<typename T>
+void SlotMap<T>::Erase(Handle handle)
+{
+	if (!IsValid(handle)) { return; }
+
+	Slot& slot = m_slots[handle.index];
+
+	reinterpret_cast<T*>(&m_values[handle.index])->~T();
+
+	//last live object takes the place of the erased one
+	const Uint32 last = m_dense.back();
+	m_dense[slot.denseIndex] = last;
+	m_slots[last].denseIndex = slot.denseIndex;
+	m_dense.pop_back();
+
+	slot.denseIndex = k_noSlot;
+	slot.generation++;
+	slot.nextFree = m_firstFree;
+	m_firstFree = handle.index;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+
+namespace
+{
+	const size_t k_initialWorkerCapacity = 16; //tasks
+}
+
+
+ThreadPool::ThreadPool(unsigned int threadCount) :
+	m_nextWorker(0),
+	m_queuedTasks(0),
+	m_unfinishedTasks(0),
+	m_isStopping(false)
+{
+	if (threadCount == 0) { threadCount = std::thread::hardware_concurrency(); }
+	if (threadCount == 0) { threadCount = 1; }
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_workers.emplace_back(new Worker);
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_threads.emplace_back([this, i]() { Run(i); });
+	}
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+
+	m_taskCondition.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+
+void ThreadPool::Submit(Task task)
+{
+	Worker& worker = *m_workers[m_nextWorker++ % m_workers.size()];
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_unfinishedTasks++;
+		m_queuedTasks++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.PushBack(std::move(task));
+	}
+
+	m_taskCondition.notify_one();
+}
+
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_idleCondition.wait(lock, [this]() { return m_unfinishedTasks == 0; });
+}
+
+
+void ThreadPool::Run(unsigned int index)
+{
+	Task task;
+
+	while (true)
+	{
+		if (TakeTask(index, task))
+		{
+			task();
+			task = nullptr;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_unfinishedTasks == 0) { m_idleCondition.notify_all(); }
+
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_taskCondition.wait(lock, [this]() { return m_isStopping || m_queuedTasks > 0; });
+
+		if (m_isStopping && m_queuedTasks == 0) { return; }
+	}
+}
+
+
+bool ThreadPool::TakeTask(unsigned int index, Task& task)
+{
+	{
+		Worker& own = *m_workers[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+
+		if (own.count > 0)
+		{
+			task = own.PopBack();
+			m_queuedTasks--;
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i < m_workers.size(); i++)
+	{
+		Worker& victim = *m_workers[(index + i) % m_workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if (victim.count > 0)
+		{
+			task = victim.PopFront();
+			m_queuedTasks--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void ThreadPool::Worker::PushBack(Task&& task)
+{
+	if (count == tasks.size())
+	{
+		std::vector<Task> grown(std::max(tasks.size() * 2, k_initialWorkerCapacity));
+
+		for (size_t i = 0; i < count; i++)
+		{
+			grown[i] = std::move(tasks[(first + i) % tasks.size()]);
+		}
+
+		tasks.swap(grown);
+		first = 0;
+	}
+
+	tasks[(first + count) % tasks.size()] = std::move(task);
+	count++;
+}
+
+
+ThreadPool::Task ThreadPool::Worker::PopBack()
+{
+	count--;
+
+	Task task = std::move(tasks[(first + count) % tasks.size()]);
+	tasks[(first + count) % tasks.size()] = nullptr;
+
+	return task;
+}
+
+
+ThreadPool::Task ThreadPool::Worker::PopFront()
+{
+	Task task = std::move(tasks[first]);
+	tasks[first] = nullptr;
+
+	first = (first + 1) % tasks.size();
+	count--;
+
+	return task;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// every worker owns a task deque: it takes its own tasks from the back
+// and steals from the front of other workers' deques when its own is empty.
+// Deques are ring buffers that only grow, so a steady load doesn't allocate
+
+
+class ThreadPool
+{
+public:
+	using Task = std::function<void()>;
+
+	explicit ThreadPool(unsigned int threadCount = 0); //0 means hardware concurrency
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool& operator= (const ThreadPool& other) = delete;
+
+	void Submit(Task task);
+	void Wait(); //blocks until all submitted tasks are finished
+
+	inline unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_threads.size()); }
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::vector<Task> tasks; //ring buffer
+		size_t first;
+		size_t count;
+
+		Worker() : first(0), count(0) {}
+
+		void PushBack(Task&& task);
+		Task PopBack();
+		Task PopFront();
+	};
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_taskCondition;
+	std::condition_variable m_idleCondition;
+
+	std::atomic<unsigned int> m_nextWorker;
+	std::atomic<size_t> m_queuedTasks; //submitted but not taken by any worker
+	size_t m_unfinishedTasks; //guarded by m_mutex
+	bool m_isStopping; //guarded by m_mutex
+
+	void Run(unsigned int index);
+	bool TakeTask(unsigned int index, Task& task);
+};
\ No newline at end of file